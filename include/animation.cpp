@@ -0,0 +1,52 @@
+#include "animation.h"
+#include "window.h"
+
+void AnimationObserver::show(const int index, const nodeState state) {
+    const int slot = indexToSlot[index];
+    if (slot == startNode || slot == endNode) return;
+    nodes.state(slot) = state;
+    if (animate) animateStep(nodes, edgeData, window, step);
+}
+
+// thicken the editor edge between the two slots, whichever direction it is stored in
+void AnimationObserver::markEdge(const int fromSlot, const int toSlot) {
+    for (auto& e: edgeData[fromSlot]) {
+        if (get<0>(e) == toSlot) {
+            get<2>(e) = 3; // modify edge size to indicate this edge was taken
+            return;
+        }
+    }
+    for (auto& e: edgeData[toSlot]) {
+        if (get<0>(e) == fromSlot) {
+            get<2>(e) = 3;
+            return;
+        }
+    }
+}
+
+void AnimationObserver::treeEdge(const int u, const int v) {
+    nodes.state(indexToSlot[u]) = Path;
+    nodes.state(indexToSlot[v]) = Path;
+    markEdge(indexToSlot[u], indexToSlot[v]);
+    if (animate) animateStep(nodes, edgeData, window, step);
+}
+
+void AnimationObserver::showPath(const vector<int>& path) {
+    for (int i = 0; i + 1 < static_cast<int>(path.size()); i++) {
+        markEdge(indexToSlot[path[i]], indexToSlot[path[i + 1]]);
+        if (indexToSlot[path[i]] != startNode) {
+            nodes.state(indexToSlot[path[i]]) = Path;
+            if (animate) animateStep(nodes, edgeData, window, chrono::milliseconds(50));
+        }
+    }
+    if (animate) refreshScreen(nodes, edgeData, window);
+}
+
+void AnimationObserver::showNoPath() {
+    for (auto& state: nodes.states()) {
+        if (state == Visited) {
+            state = VisitedNoPath;
+        }
+    }
+    if (animate) refreshScreen(nodes, edgeData, window);
+}
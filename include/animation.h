@@ -0,0 +1,34 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "nodestore.h"
+#include "states.h"
+
+// engine observer that animates a run on the editor graph
+// engines work on a snapshot numbered 0..n-1, indexToSlot maps those indices back to node slots
+struct AnimationObserver {
+    NodeStore& nodes;
+    EdgeMap& edgeData;
+    RenderWindow& window;
+    const vector<int>& indexToSlot;
+    int startNode = -1; // slots that keep their Start/End colour
+    int endNode = -1;
+    nodeState improvedState = InQueue;
+    chrono::milliseconds step{10};
+    bool animate = true; // false only sets the states, the main loop draws the result on its next frame
+
+    void popped(int u) { show(u, CurrentNode); }
+    void improved(int v) { show(v, improvedState); }
+    void settled(int u) { show(u, Visited); }
+    void treeEdge(int u, int v);
+
+    // colour the path's nodes and thicken its edges, one step at a time
+    void showPath(const vector<int>& path);
+    // turn everything visited grey after a search found nothing
+    void showNoPath();
+
+private:
+    void show(int index, nodeState state);
+    void markEdge(int fromSlot, int toSlot);
+};
@@ -0,0 +1,21 @@
+#include "components.h"
+
+void ComponentIndex::update(const NodeStore& nodes, const EdgeMap& edgeData, const long long version) {
+    if (version == builtVersion) return;
+    vector<int> indexToSlot;
+    index.build(snapshotGraph(nodes, edgeData, indexToSlot, &slotToIndex));
+    builtVersion = version;
+
+    vector<int> sizes(index.numComponents(), 0);
+    for (int i = 0; i < static_cast<int>(indexToSlot.size()); i++) sizes[index.component(i)]++;
+    slotLabels.assign(nodes.capacity(), -1);
+    for (int i = 0; i < static_cast<int>(indexToSlot.size()); i++) {
+        if (sizes[index.component(i)] > 1) slotLabels[indexToSlot[i]] = index.component(i);
+    }
+}
+
+bool ComponentIndex::reachable(const int fromSlot, const int toSlot) const {
+    const auto isLive = [this](const int slot) { return slot >= 0 && slot < static_cast<int>(slotToIndex.size()) && slotToIndex[slot] != -1; };
+    if (!isLive(fromSlot) || !isLive(toSlot)) return false;
+    return index.reachable(slotToIndex[fromSlot], slotToIndex[toSlot]);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+#include "nodestore.h"
+#include "reachability.h"
+using namespace std;
+
+// strongly connected components of the editor graph, indexed by node slot
+// rebuilt at most once per graph version, after which an unreachable start/end pair is rejected without a search
+class ComponentIndex {
+public:
+    // make sure the index matches the graph at version
+    void update(const NodeStore& nodes, const EdgeMap& edgeData, long long version);
+
+    bool reachable(int fromSlot, int toSlot) const; // false when either slot is free
+    int numComponents() const { return index.numComponents(); }
+    // component of every slot, -1 for free slots and for nodes that form a component on their own
+    const vector<int>& labels() const { return slotLabels; }
+
+private:
+    ReachabilityIndex index;
+    long long builtVersion = -1;
+    vector<int> slotToIndex;
+    vector<int> slotLabels;
+};
@@ -0,0 +1,409 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "graph.h"
+#include "runstats.h"
+#include "profiler.h"
+using namespace std;
+
+// shortest path and mst engines, templated on the graph (weight type + direction policy) and an observer policy
+// the observer is told about every search step; with NullObserver the hooks are empty inline calls and compile away,
+// so the headless runner and the animated app share the same source
+
+struct NullObserver {
+    void popped(int) {} // node taken off the queue
+    void improved(int) {} // node's tentative distance went down
+    void settled(int) {} // node's distance is final
+    void treeEdge(int, int) {} // edge added to the spanning tree
+};
+
+// long long for integer weights, double for floating point ones
+template <typename Weight>
+using DistanceOf = conditional_t<is_floating_point_v<Weight>, double, long long>;
+
+// per thread search state, kept between queries so it is only allocated once
+// every entry carries the generation it was written in; entries from older queries read as unreached,
+// so starting a query is o(1) instead of refilling o(V) arrays
+template <typename Dist>
+class BasicWorkspace {
+public:
+    static constexpr Dist infinity = numeric_limits<Dist>::max();
+
+    // start a new query; only touches the arrays when the graph grew or the generation counter wrapped around
+    void prepare(const int numNodes) {
+        if (numNodes > static_cast<int>(entries.size())) entries.resize(numNodes);
+        frontier.clear();
+        if (++generation == 0) { // after a wrap old stamps could look current again
+            for (auto& entry: entries) entry.stamp = 0;
+            generation = 1;
+        }
+    }
+
+    Dist distance(const int v) const { return current(v) ? entries[v].dist : infinity; }
+    int parent(const int v) const { return current(v) ? entries[v].parent : -1; }
+    bool settled(const int v) const { return current(v) && entries[v].settled; }
+
+    void improve(const int v, const Dist dist, const int from) {
+        Entry& entry = entries[v];
+        if (entry.stamp != generation) {
+            entry.stamp = generation;
+            entry.settled = false;
+        }
+        entry.dist = dist;
+        entry.parent = from;
+    }
+    void settle(const int v) { entries[v].settled = true; } // v must have been reached in this query
+
+    // dijkstra's binary min heap of <distance, node>, kept here so a paused search can be resumed
+    vector<pair<Dist, int>> frontier;
+
+    size_t bytes() const { return entries.capacity() * sizeof(Entry) + frontier.capacity() * sizeof(pair<Dist, int>); }
+
+private:
+    // one entry per node so a relaxation touches a single cache line
+    struct Entry {
+        Dist dist;
+        int parent;
+        uint32_t stamp = 0;
+        bool settled;
+    };
+
+    bool current(const int v) const { return entries[v].stamp == generation; }
+
+    vector<Entry> entries;
+    uint32_t generation = 0;
+};
+
+// the calling thread's workspace, reused by every query it runs
+template <typename Dist>
+BasicWorkspace<Dist>& threadWorkspace() {
+    thread_local BasicWorkspace<Dist> workspace;
+    return workspace;
+}
+
+template <typename Dist>
+struct BasicPathResult {
+    bool reachable = false;
+    bool negativeCycle = false;
+    Dist distance = 0;
+    vector<int> path; // start to end, empty when unreachable
+};
+
+template <typename Dist>
+struct BasicMstResult {
+    Dist weight = 0;
+    int numEdges = 0;
+};
+
+using SearchWorkspace = BasicWorkspace<long long>;
+using PathResult = BasicPathResult<long long>;
+using MstResult = BasicMstResult<long long>;
+
+namespace engine_detail {
+
+template <typename Dist>
+void tracePath(const BasicWorkspace<Dist>& ws, const int endNode, BasicPathResult<Dist>& result) {
+    for (int at = endNode; at != -1; at = ws.parent(at)) {
+        result.path.push_back(at);
+    }
+    reverse(result.path.begin(), result.path.end());
+}
+
+inline int findRoot(vector<int>& parent, int u) {
+    while (parent[u] != u) {
+        parent[u] = parent[parent[u]]; // path halving
+        u = parent[u];
+    }
+    return u;
+}
+
+}
+
+// new search from startNode in ws, nothing settled yet
+template <typename Graph, typename Dist>
+void startDijkstra(const Graph& graph, const int startNode, BasicWorkspace<Dist>& ws) {
+    ws.prepare(graph.numNodes());
+    ws.improve(startNode, 0, -1);
+    ws.frontier.emplace_back(0, startNode);
+}
+
+// continue the dijkstra search from startNode held in ws until endNode is settled or nothing is left to settle
+// the search stays paused in ws, so a later call for another target picks up where this one stopped;
+// a target settled earlier costs only the walk back along its parents
+// with potentials, searches on the reduced costs w + h[u] - h[v] and reports the distance in original weights
+template <typename Graph, typename Observer = NullObserver, typename Dist = DistanceOf<typename Graph::WeightType>>
+BasicPathResult<Dist> resumeDijkstra(const Graph& graph, const int startNode, const int endNode, BasicWorkspace<Dist>& ws,
+                                     Observer&& observer = {}, const vector<Dist>* potentials = nullptr) {
+    PROFILE_SCOPE("dijkstraQuery");
+    STATS_RUN(potentials ? "johnson" : "dijkstra");
+    BasicPathResult<Dist> result;
+    if (endNode < 0 || endNode >= graph.numNodes()) return result;
+
+    auto& pq = ws.frontier;
+    while (!ws.settled(endNode) && !pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), greater<>());
+        const auto [d, u] = pq.back();
+        pq.pop_back();
+        if (ws.settled(u)) {
+            STATS_INC(stalePops);
+            continue;
+        }
+        observer.popped(u);
+        STATS_INC(nodesSettled);
+        ws.settle(u); // before relaxing, so a negative self loop can not make u its own parent
+
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            const int v = graph.targets[e];
+            // with negative weights a settled node could still be lowered; its parent would change after its
+            // children's and could close a loop, so settled nodes keep their distance (dijkstra may be wrong, but ends)
+            if (ws.settled(v)) continue;
+            Dist weight = graph.weights[e];
+            if (potentials) weight += (*potentials)[u] - (*potentials)[v];
+            const Dist newDist = d + weight;
+            STATS_INC(edgesRelaxed);
+            if (newDist < ws.distance(v)) {
+                ws.improve(v, newDist, u);
+                pq.emplace_back(newDist, v);
+                push_heap(pq.begin(), pq.end(), greater<>());
+                STATS_INC(heapPushes);
+                observer.improved(v);
+            }
+        }
+        STATS_PEAK(peakQueueSize, pq.size());
+        observer.settled(u);
+    }
+
+    if (ws.settled(endNode)) {
+        result.reachable = true;
+        result.distance = ws.distance(endNode);
+        if (potentials) result.distance += (*potentials)[endNode] - (*potentials)[startNode];
+        engine_detail::tracePath(ws, endNode, result);
+    }
+    return result;
+}
+
+// start a fresh search from startNode, stopping once endNode is settled
+template <typename Graph, typename Observer = NullObserver, typename Dist = DistanceOf<typename Graph::WeightType>>
+BasicPathResult<Dist> dijkstraQuery(const Graph& graph, const int startNode, const int endNode, BasicWorkspace<Dist>& ws,
+                                    Observer&& observer = {}, const vector<Dist>* potentials = nullptr) {
+    if (startNode < 0 || startNode >= graph.numNodes()) return {};
+    startDijkstra(graph, startNode, ws);
+    return resumeDijkstra(graph, startNode, endNode, ws, observer, potentials);
+}
+
+template <typename Graph, typename Observer = NullObserver, typename Dist = DistanceOf<typename Graph::WeightType>>
+BasicPathResult<Dist> bellmanFordQuery(const Graph& graph, const int startNode, const int endNode, BasicWorkspace<Dist>& ws,
+                                       Observer&& observer = {}) {
+    PROFILE_SCOPE("bellmanFordQuery");
+    STATS_RUN("bellman-ford");
+    BasicPathResult<Dist> result;
+    if (startNode < 0 || startNode >= graph.numNodes() || endNode < 0 || endNode >= graph.numNodes()) return result;
+    ws.prepare(graph.numNodes());
+    ws.improve(startNode, 0, -1);
+
+    // |V| - 1 rounds, stopping early once a round changes nothing; a change in round |V| means a negative cycle
+    bool changed = true;
+    for (int round = 0; round < graph.numNodes() && changed; round++) {
+        PROFILE_SCOPE("bellman-ford round");
+        STATS_INC(bellmanFordRounds);
+        changed = false;
+        for (int u = 0; u < graph.numNodes(); u++) {
+            const Dist distU = ws.distance(u);
+            if (distU == ws.infinity) continue;
+            for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+                const int v = graph.targets[e];
+                STATS_INC(edgesRelaxed);
+                if (distU + graph.weights[e] < ws.distance(v)) {
+                    ws.improve(v, distU + graph.weights[e], u);
+                    changed = true;
+                    observer.improved(v);
+                }
+            }
+        }
+    }
+    if (changed) {
+        result.negativeCycle = true;
+        return result;
+    }
+
+    if (ws.distance(endNode) != ws.infinity) {
+        result.reachable = true;
+        result.distance = ws.distance(endNode);
+        engine_detail::tracePath(ws, endNode, result);
+    }
+    return result;
+}
+
+// johnson's potentials: bellman-ford from a virtual source joined to every node by a 0 weight edge
+// afterwards w + h[u] - h[v] >= 0 for every edge; false if the graph has a negative cycle
+template <typename Graph, typename Dist = DistanceOf<typename Graph::WeightType>>
+bool computePotentials(const Graph& graph, vector<Dist>& potentials) {
+    PROFILE_SCOPE("computePotentials");
+    STATS_RUN("johnson potentials");
+    potentials.assign(graph.numNodes(), 0); // the virtual source reaches every node with distance 0
+
+    bool changed = true;
+    for (int round = 0; round <= graph.numNodes() && changed; round++) { // |V| + 1 nodes including the source
+        STATS_INC(bellmanFordRounds);
+        changed = false;
+        for (int u = 0; u < graph.numNodes(); u++) {
+            for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+                const int v = graph.targets[e];
+                STATS_INC(edgesRelaxed);
+                if (potentials[u] + graph.weights[e] < potentials[v]) {
+                    potentials[v] = potentials[u] + graph.weights[e];
+                    changed = true;
+                }
+            }
+        }
+    }
+    return !changed;
+}
+
+// strongly connected components with an iterative tarjan, so deep graphs can not overflow the call stack
+// components are numbered in reverse topological order: an edge between two components always goes to the lower number
+// returns the number of components
+template <typename Graph>
+int stronglyConnectedComponents(const Graph& graph, vector<int>& component) {
+    PROFILE_SCOPE("stronglyConnectedComponents");
+    const int n = graph.numNodes();
+    component.assign(n, -1);
+    vector<int> order(n, -1); // discovery order, -1 = not visited yet
+    vector<int> low(n);
+    vector<int> nextEdge(n); // where the dfs continues in u's edge list
+    vector<int> open; // visited nodes without a component yet, tarjan's stack
+    vector<int> path; // the dfs call stack
+    int visited = 0;
+    int numComponents = 0;
+
+    for (int root = 0; root < n; root++) {
+        if (order[root] != -1) continue;
+        path.push_back(root);
+        while (!path.empty()) {
+            const int u = path.back();
+            if (order[u] == -1) {
+                order[u] = low[u] = visited++;
+                nextEdge[u] = graph.offsets[u];
+                open.push_back(u);
+            }
+            bool descended = false;
+            while (nextEdge[u] < graph.offsets[u + 1]) {
+                const int v = graph.targets[nextEdge[u]++];
+                if (order[v] == -1) {
+                    path.push_back(v);
+                    descended = true;
+                    break;
+                }
+                if (component[v] == -1) low[u] = min(low[u], order[v]); // v is still open, so it is on the current path's cycle
+            }
+            if (descended) continue;
+
+            path.pop_back();
+            if (!path.empty()) low[path.back()] = min(low[path.back()], low[u]);
+            if (low[u] == order[u]) { // u is the first node of its component, everything opened after it belongs to it
+                int w;
+                do {
+                    w = open.back();
+                    open.pop_back();
+                    component[w] = numComponents;
+                } while (w != u);
+                numComponents++;
+            }
+        }
+    }
+    return numComponents;
+}
+
+// edges are treated as undirected; a disconnected graph gives a minimum spanning forest
+template <typename Graph, typename Observer = NullObserver, typename Dist = DistanceOf<typename Graph::WeightType>>
+BasicMstResult<Dist> kruskalMst(const Graph& graph, Observer&& observer = {}) {
+    PROFILE_SCOPE("kruskalMst");
+    STATS_RUN("kruskal");
+    using Weight = typename Graph::WeightType;
+    vector<tuple<Weight, int, int>> edges; // <weight, u, v>
+    edges.reserve(graph.numEdges());
+    for (int u = 0; u < graph.numNodes(); u++) {
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            // undirected storage holds every edge twice, keep one copy
+            if (Graph::DirectionPolicy::undirected && graph.targets[e] < u) continue;
+            edges.emplace_back(graph.weights[e], u, graph.targets[e]);
+        }
+    }
+    {
+        PROFILE_SCOPE("kruskal sort");
+        sort(edges.begin(), edges.end());
+    }
+
+    vector<int> parent(graph.numNodes());
+    iota(parent.begin(), parent.end(), 0);
+    BasicMstResult<Dist> result;
+    for (const auto& [weight, u, v]: edges) {
+        STATS_ADD(unionFindOps, 2);
+        const int rootU = engine_detail::findRoot(parent, u);
+        const int rootV = engine_detail::findRoot(parent, v);
+        if (rootU == rootV) continue;
+        STATS_INC(unionFindOps);
+        parent[rootV] = rootU;
+        result.weight += weight;
+        result.numEdges++;
+        observer.treeEdge(u, v);
+    }
+    return result;
+}
+
+template <typename Graph, typename Observer = NullObserver, typename Dist = DistanceOf<typename Graph::WeightType>>
+BasicMstResult<Dist> primMst(const Graph& graph, Observer&& observer = {}) {
+    PROFILE_SCOPE("primMst");
+    STATS_RUN("prim");
+    using Weight = typename Graph::WeightType;
+    // directed storage needs the reversed edges as well to see the undirected graph
+    Graph reversed;
+    if constexpr (!Graph::DirectionPolicy::undirected) reversed = transposeGraph(graph);
+    vector<char> inTree(graph.numNodes(), 0);
+    using Entry = tuple<Weight, int, int>; // <weight, node, reached from>
+    priority_queue<Entry, vector<Entry>, greater<>> pq;
+    BasicMstResult<Dist> result;
+
+    auto pushEdges = [&](const Graph& g, const int u) {
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; e++) {
+            STATS_INC(edgesRelaxed);
+            if (!inTree[g.targets[e]]) {
+                pq.emplace(g.weights[e], g.targets[e], u);
+                STATS_INC(heapPushes);
+            }
+        }
+    };
+    auto addNode = [&](const int u) {
+        inTree[u] = 1;
+        STATS_INC(nodesSettled);
+        pushEdges(graph, u);
+        if constexpr (!Graph::DirectionPolicy::undirected) pushEdges(reversed, u);
+    };
+
+    for (int root = 0; root < graph.numNodes(); root++) { // restart in every component
+        if (inTree[root]) continue;
+        addNode(root);
+        while (!pq.empty()) {
+            STATS_PEAK(peakQueueSize, pq.size());
+            const auto [weight, v, from] = pq.top();
+            pq.pop();
+            if (inTree[v]) {
+                STATS_INC(stalePops);
+                continue;
+            }
+            result.weight += weight;
+            result.numEdges++;
+            observer.treeEdge(from, v);
+            addNode(v);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,332 @@
+// graph generators writing straight into the compact (CSR) representation
+
+#include "generator.h"
+#include "parallel.h"
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numbers>
+#include <utility>
+#include <vector>
+using namespace std;
+
+namespace {
+
+struct GenEdge {
+    int from;
+    int to;
+    int weight;
+};
+
+uint64_t mixBits(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// small splitmix64 generator; seeded per node so every node's edges are independent of chunking and thread count
+class SplitMix {
+public:
+    explicit SplitMix(const uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        state += 0x9E3779B97F4A7C15ULL;
+        return mixBits(state);
+    }
+
+    double uniform() { // in (0, 1]
+        return (static_cast<double>(next() >> 11) + 1.0) * 0x1.0p-53;
+    }
+
+    int range(const int lo, const int hi) { // inclusive
+        return lo + static_cast<int>(next() % static_cast<uint64_t>(hi - lo + 1));
+    }
+
+private:
+    uint64_t state;
+};
+
+enum Salt : uint64_t { PositionSalt = 1, EdgeSalt = 2 };
+
+SplitMix rngFor(const uint64_t seed, const Salt salt, const int node) {
+    return SplitMix(mixBits(seed ^ mixBits(salt * 0x100000000ULL + static_cast<uint64_t>(node))));
+}
+
+class EdgeSink {
+public:
+    EdgeSink(const GeneratorParams& params, const CompactGraph& graph, vector<GenEdge>& out, SplitMix& rng)
+        : params(params), graph(graph), out(out), rng(rng) {}
+
+    // directed arc u->v; mirrored later when the graph is bidirectional
+    void addArc(const int u, const int v) {
+        out.push_back({u, v, pickWeight(u, v)});
+    }
+
+    // undirected pair, stored in a random direction unless the graph is bidirectional
+    void addPair(const int u, const int v) {
+        const int weight = pickWeight(u, v);
+        if (params.bidirectional || (rng.next() & 1) == 0) {
+            out.push_back({u, v, weight});
+        } else {
+            out.push_back({v, u, weight});
+        }
+    }
+
+private:
+    int pickWeight(const int u, const int v) {
+        const WeightDistribution& w = params.weights;
+        if (w.kind == DistanceWeight) {
+            const float dist = hypot(graph.xs[u] - graph.xs[v], graph.ys[u] - graph.ys[v]);
+            const long scaled = lround(w.minWeight * dist / params.spacing);
+            return static_cast<int>(clamp<long>(scaled, w.minWeight, w.maxWeight));
+        }
+        return rng.range(w.minWeight, w.maxWeight);
+    }
+
+    const GeneratorParams& params;
+    const CompactGraph& graph;
+    vector<GenEdge>& out;
+    SplitMix& rng;
+};
+
+void placeNodes(const GeneratorParams& params, CompactGraph& graph, const int numChunks, const int numThreads) {
+    PROFILE_SCOPE("generator place nodes");
+    const int n = params.rows * params.cols;
+    const bool jittered = params.model == GeometricModel || params.model == DelaunayModel;
+    graph.xs.resize(n);
+    graph.ys.resize(n);
+    parallelChunks(0, n, numChunks, numThreads, [&](int, const int begin, const int end) {
+        for (int i = begin; i < end; i++) {
+            float x = params.originX + (i % params.cols) * params.spacing;
+            float y = params.originY + (i / params.cols) * params.spacing;
+            if (jittered) {
+                SplitMix rng = rngFor(params.seed, PositionSalt, i);
+                x += static_cast<float>(rng.uniform() - 0.5) * params.jitter * params.spacing;
+                y += static_cast<float>(rng.uniform() - 0.5) * params.jitter * params.spacing;
+            }
+            graph.xs[i] = x;
+            graph.ys[i] = y;
+        }
+    });
+}
+
+void gridEdges(const GeneratorParams& params, const int u, EdgeSink& sink) {
+    // right, down, bottom right, bottom left
+    constexpr int dRow[] = {0, 1, 1, 1};
+    constexpr int dCol[] = {1, 0, 1, -1};
+    const int numDirections = params.degree >= 8 ? 4 : params.degree >= 6 ? 3 : 2;
+    const int row = u / params.cols;
+    const int col = u % params.cols;
+    for (int dir = 0; dir < numDirections; dir++) {
+        const int r = row + dRow[dir];
+        const int c = col + dCol[dir];
+        if (r >= params.rows || c < 0 || c >= params.cols) continue;
+        sink.addPair(u, r * params.cols + c);
+    }
+}
+
+void erdosRenyiEdges(const GeneratorParams& params, const int u, SplitMix& rng, EdgeSink& sink) {
+    const int n = params.rows * params.cols;
+    if (n < 2) return;
+    const double p = min(1.0, static_cast<double>(params.degree) / (n - 1));
+    // undirected graphs only sample v > u and get mirrored, directed graphs sample every v != u
+    int v = params.bidirectional ? u : -1;
+    if (p >= 1.0) {
+        for (v++; v < n; v++) {
+            if (v != u) sink.addArc(u, v);
+        }
+        return;
+    }
+    // jump straight to the next success instead of rolling for every pair
+    const double logMiss = log1p(-p);
+    while (true) {
+        const double next = v + 1 + floor(log(rng.uniform()) / logMiss);
+        if (next >= n) break;
+        v = static_cast<int>(next);
+        if (v != u) sink.addArc(u, v);
+    }
+}
+
+void geometricEdges(const GeneratorParams& params, const CompactGraph& graph, const int u, EdgeSink& sink) {
+    const float radius = params.spacing * sqrt(static_cast<float>(params.degree) / numbers::pi_v<float>);
+    const float radiusSq = radius * radius;
+    // jitter can pull points from further slots inside the radius
+    const int reach = static_cast<int>(ceil((radius + params.jitter * params.spacing) / params.spacing));
+    const int row = u / params.cols;
+    const int col = u % params.cols;
+    for (int dr = 0; dr <= reach; dr++) {
+        const int r = row + dr;
+        if (r >= params.rows) break;
+        for (int dc = (dr == 0 ? 1 : -reach); dc <= reach; dc++) { // forward half so each pair is seen once
+            const int c = col + dc;
+            if (c < 0 || c >= params.cols) continue;
+            const int v = r * params.cols + c;
+            const float dx = graph.xs[u] - graph.xs[v];
+            const float dy = graph.ys[u] - graph.ys[v];
+            if (dx * dx + dy * dy <= radiusSq) sink.addPair(u, v);
+        }
+    }
+}
+
+// true if p lies inside the circumcircle of triangle abc
+bool inCircumcircle(const CompactGraph& g, const int a, const int b, const int c, const int p) {
+    const double adx = g.xs[a] - g.xs[p], ady = g.ys[a] - g.ys[p];
+    const double bdx = g.xs[b] - g.xs[p], bdy = g.ys[b] - g.ys[p];
+    const double cdx = g.xs[c] - g.xs[p], cdy = g.ys[c] - g.ys[p];
+    const double det = (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+                     - (bdx * bdx + bdy * bdy) * (adx * cdy - cdx * ady)
+                     + (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+    const double orientation = (g.xs[b] - g.xs[a]) * (g.ys[c] - g.ys[a]) - (g.ys[b] - g.ys[a]) * (g.xs[c] - g.xs[a]);
+    return det * orientation > 0;
+}
+
+// triangulate every lattice cell of the jittered points, picking the diagonal that satisfies the delaunay condition
+void delaunayEdges(const GeneratorParams& params, const CompactGraph& graph, const int u, EdgeSink& sink) {
+    const int row = u / params.cols;
+    const int col = u % params.cols;
+    const bool hasRight = col + 1 < params.cols;
+    const bool hasDown = row + 1 < params.rows;
+    if (hasRight) sink.addPair(u, u + 1);
+    if (hasDown) sink.addPair(u, u + params.cols);
+    if (hasRight && hasDown) {
+        const int topRight = u + 1;
+        const int bottomLeft = u + params.cols;
+        const int bottomRight = bottomLeft + 1;
+        if (inCircumcircle(graph, u, topRight, bottomRight, bottomLeft)) {
+            sink.addPair(topRight, bottomLeft);
+        } else {
+            sink.addPair(u, bottomRight);
+        }
+    }
+}
+
+// preferential attachment is inherently sequential; sampling endpoints from the edge list keeps it O(E)
+void barabasiAlbertEdges(const GeneratorParams& params, const CompactGraph& graph, vector<GenEdge>& out) {
+    const int n = params.rows * params.cols;
+    const int m = max(1, params.degree);
+    SplitMix rng = rngFor(params.seed, EdgeSalt, -1);
+    EdgeSink sink(params, graph, out, rng);
+    vector<int> endpoints; // every node appears once per incident edge
+    endpoints.reserve(2 * static_cast<size_t>(n) * m);
+    vector<int> picked;
+    for (int v = 1; v < n; v++) {
+        picked.clear();
+        if (v <= m) {
+            for (int t = 0; t < v; t++) picked.push_back(t);
+        } else {
+            while (picked.size() < static_cast<size_t>(m)) {
+                const int t = endpoints[rng.next() % endpoints.size()];
+                if (find(picked.begin(), picked.end(), t) == picked.end()) picked.push_back(t);
+            }
+        }
+        for (const int t: picked) {
+            sink.addPair(v, t);
+            endpoints.push_back(v);
+            endpoints.push_back(t);
+        }
+    }
+}
+
+// counting-sort the per chunk edge lists into CSR, then order each adjacency list so output is deterministic
+void buildCompact(CompactGraph& graph, vector<vector<GenEdge>>& chunks, const bool mirror, const int numThreads) {
+    PROFILE_SCOPE("generator build csr");
+    const int n = static_cast<int>(graph.xs.size());
+    const int numChunks = static_cast<int>(chunks.size());
+    vector<atomic<int>> cursor(n);
+    parallelChunks(0, numChunks, numChunks, numThreads, [&](int, const int begin, const int end) {
+        for (int chunk = begin; chunk < end; chunk++) {
+            for (const auto& e: chunks[chunk]) {
+                cursor[e.from].fetch_add(1, memory_order_relaxed);
+                if (mirror) cursor[e.to].fetch_add(1, memory_order_relaxed);
+            }
+        }
+    });
+
+    graph.offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; u++) {
+        graph.offsets[u + 1] = graph.offsets[u] + cursor[u].load(memory_order_relaxed);
+        cursor[u].store(graph.offsets[u], memory_order_relaxed);
+    }
+    graph.targets.resize(graph.offsets[n]);
+    graph.weights.resize(graph.offsets[n]);
+
+    parallelChunks(0, numChunks, numChunks, numThreads, [&](int, const int begin, const int end) {
+        for (int chunk = begin; chunk < end; chunk++) {
+            for (const auto& e: chunks[chunk]) {
+                int slot = cursor[e.from].fetch_add(1, memory_order_relaxed);
+                graph.targets[slot] = e.to;
+                graph.weights[slot] = e.weight;
+                if (mirror) {
+                    slot = cursor[e.to].fetch_add(1, memory_order_relaxed);
+                    graph.targets[slot] = e.from;
+                    graph.weights[slot] = e.weight;
+                }
+            }
+            vector<GenEdge>().swap(chunks[chunk]);
+        }
+    });
+
+    parallelChunks(0, n, numChunks, numThreads, [&](int, const int begin, const int end) {
+        vector<pair<int, int>> adjacency;
+        for (int u = begin; u < end; u++) {
+            adjacency.clear();
+            for (int i = graph.offsets[u]; i < graph.offsets[u + 1]; i++) {
+                adjacency.emplace_back(graph.targets[i], graph.weights[i]);
+            }
+            sort(adjacency.begin(), adjacency.end());
+            for (int i = graph.offsets[u]; i < graph.offsets[u + 1]; i++) {
+                tie(graph.targets[i], graph.weights[i]) = adjacency[i - graph.offsets[u]];
+            }
+        }
+    });
+}
+
+} // namespace
+
+const char* graphModelName(const GraphModel model) {
+    switch (model) {
+        case GridModel: return "grid";
+        case ErdosRenyiModel: return "erdos-renyi";
+        case GeometricModel: return "random geometric";
+        case BarabasiAlbertModel: return "barabasi-albert";
+        case DelaunayModel: return "delaunay";
+        default: return "unknown";
+    }
+}
+
+CompactGraph generateGraph(const GeneratorParams& params) {
+    PROFILE_SCOPE("generateGraph");
+    CompactGraph graph;
+    const int n = max(0, params.rows) * max(0, params.cols);
+    const int numThreads = params.numThreads > 0 ? params.numThreads : defaultThreadCount();
+    const int numChunks = max(1, min(n, numThreads * 8));
+    if (n == 0) return graph;
+
+    placeNodes(params, graph, numChunks, numThreads);
+
+    vector<vector<GenEdge>> chunks(numChunks);
+    if (params.model == BarabasiAlbertModel) {
+        barabasiAlbertEdges(params, graph, chunks[0]);
+    } else {
+        parallelChunks(0, n, numChunks, numThreads, [&](const int chunk, const int begin, const int end) {
+            PROFILE_SCOPE("generator edge chunk");
+            vector<GenEdge>& out = chunks[chunk];
+            for (int u = begin; u < end; u++) {
+                SplitMix rng = rngFor(params.seed, EdgeSalt, u);
+                EdgeSink sink(params, graph, out, rng);
+                switch (params.model) {
+                    case GridModel: gridEdges(params, u, sink); break;
+                    case ErdosRenyiModel: erdosRenyiEdges(params, u, rng, sink); break;
+                    case GeometricModel: geometricEdges(params, graph, u, sink); break;
+                    case DelaunayModel: delaunayEdges(params, graph, u, sink); break;
+                    default: break;
+                }
+            }
+        });
+    }
+
+    buildCompact(graph, chunks, params.bidirectional, numThreads);
+    return graph;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include "graph.h"
+
+enum GraphModel {
+    GridModel, // lattice with 4, 6 or 8 neighbours per node
+    ErdosRenyiModel, // every ordered pair connected with probability degree/(n-1)
+    GeometricModel, // jittered points connected when closer than a radius giving ~degree neighbours
+    BarabasiAlbertModel, // preferential attachment, each new node links to `degree` existing nodes
+    DelaunayModel, // road-like planar triangulation of jittered points
+};
+
+enum WeightKind {
+    UniformWeight, // uniform integer in [minWeight, maxWeight]
+    DistanceWeight, // euclidean length, one lattice step = minWeight, clamped to maxWeight
+};
+
+struct WeightDistribution {
+    WeightKind kind = UniformWeight;
+    int minWeight = 1;
+    int maxWeight = 5;
+};
+
+struct GeneratorParams {
+    GraphModel model = GridModel;
+    int rows = 10; // nodes are laid out on a rows x cols lattice of slots
+    int cols = 10;
+    float spacing = 47.f; // distance between neighbouring slots
+    float originX = 0.f; // position of slot (0, 0)
+    float originY = 0.f;
+    float jitter = 0.5f; // geometric/delaunay: max offset from the slot centre as a fraction of spacing
+    int degree = 6; // grid: 4/6/8 neighbours, erdos-renyi/geometric: expected degree, barabasi-albert: links per new node
+    bool bidirectional = false; // add both directions of every edge, otherwise pick one at random
+    uint64_t seed = 1;
+    WeightDistribution weights;
+    int numThreads = 0; // 0 = hardware concurrency
+};
+
+const char* graphModelName(GraphModel model);
+
+CompactGraph generateGraph(const GeneratorParams& params);
@@ -0,0 +1,95 @@
+#include "graph.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+void fillEdges(CompactGraph& graph, const int numNodes, const vector<tuple<int, int, int>>& edges) {
+    graph.offsets.assign(numNodes + 1, 0);
+    for (const auto& [from, to, weight]: edges) {
+        graph.offsets[from + 1]++;
+    }
+    for (int u = 0; u < numNodes; u++) {
+        graph.offsets[u + 1] += graph.offsets[u];
+    }
+    graph.targets.resize(edges.size());
+    graph.weights.resize(edges.size());
+    vector<int> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (const auto& [from, to, weight]: edges) {
+        const int slot = cursor[from]++;
+        graph.targets[slot] = to;
+        graph.weights[slot] = weight;
+    }
+}
+
+bool loadGraph(const string& path, CompactGraph& graph, string& error) {
+    ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    graph = CompactGraph{};
+    int numNodes = -1;
+    int numEdges = 0;
+    vector<tuple<int, int, int>> edges;
+    string line;
+    for (int lineNumber = 1; getline(in, line); lineNumber++) {
+        istringstream fields(line);
+        string kind;
+        if (!(fields >> kind) || kind[0] == '#') continue;
+
+        bool ok = true;
+        if (kind == "p") {
+            ok = static_cast<bool>(fields >> numNodes >> numEdges) && numNodes >= 0 && numEdges >= 0;
+            if (ok) edges.reserve(min(numEdges, 1 << 20)); // the header is not trusted with an allocation, edges grow past this
+        } else if (kind == "v") {
+            float x, y;
+            ok = static_cast<bool>(fields >> x >> y);
+            graph.xs.push_back(x);
+            graph.ys.push_back(y);
+        } else if (kind == "e") {
+            int from, to, weight;
+            ok = static_cast<bool>(fields >> from >> to >> weight) && numNodes >= 0
+                 && from >= 0 && from < numNodes && to >= 0 && to < numNodes;
+            edges.emplace_back(from, to, weight);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            error = path + ":" + to_string(lineNumber) + ": bad record '" + line + "'";
+            return false;
+        }
+    }
+
+    if (numNodes < 0) {
+        error = path + ": missing 'p <numNodes> <numEdges>' line";
+        return false;
+    }
+    if (static_cast<int>(edges.size()) != numEdges) {
+        error = path + ": expected " + to_string(numEdges) + " 'e' lines, found " + to_string(edges.size());
+        return false;
+    }
+    if (!graph.xs.empty() && static_cast<int>(graph.xs.size()) != numNodes) {
+        error = path + ": expected " + to_string(numNodes) + " 'v' lines";
+        return false;
+    }
+    graph.xs.resize(numNodes, 0);
+    graph.ys.resize(numNodes, 0);
+    fillEdges(graph, numNodes, edges);
+    return true;
+}
+
+bool saveGraph(const string& path, const CompactGraph& graph) {
+    ofstream out(path);
+    if (!out) return false;
+    out << "p " << graph.numNodes() << " " << graph.numEdges() << "\n";
+    for (int u = 0; u < graph.numNodes(); u++) {
+        out << "v " << graph.xs[u] << " " << graph.ys[u] << "\n";
+    }
+    for (int u = 0; u < graph.numNodes(); u++) {
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            out << "e " << u << " " << graph.targets[e] << " " << graph.weights[e] << "\n";
+        }
+    }
+    return static_cast<bool>(out);
+}
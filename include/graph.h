@@ -0,0 +1,112 @@
+#pragma once
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+// direction policies; undirected graphs store every edge in both adjacency lists
+struct Directed {
+    static constexpr bool undirected = false;
+};
+
+struct Undirected {
+    static constexpr bool undirected = true;
+};
+
+// compressed sparse row graph used by the generators and engines
+// out edges of node u are targets/weights[offsets[u] .. offsets[u+1])
+template <typename Weight, typename Direction = Directed>
+struct BasicGraph {
+    using WeightType = Weight;
+    using DirectionPolicy = Direction;
+
+    vector<float> xs; // node positions, one entry per node
+    vector<float> ys;
+    vector<int> offsets{0};
+    vector<int> targets;
+    vector<Weight> weights;
+
+    int numNodes() const { return static_cast<int>(offsets.size()) - 1; }
+    int numEdges() const { return static_cast<int>(targets.size()); }
+};
+
+// the editor, generators and graph files all use int weights on directed edges
+using CompactGraph = BasicGraph<int, Directed>;
+
+// build the csr arrays from an edge list of <from, to, weight>; positions are left untouched
+void fillEdges(CompactGraph& graph, int numNodes, const vector<tuple<int, int, int>>& edges);
+
+// same nodes with every edge reversed
+template <typename Weight, typename Direction>
+BasicGraph<Weight, Direction> transposeGraph(const BasicGraph<Weight, Direction>& graph) {
+    BasicGraph<Weight, Direction> reversed;
+    reversed.xs = graph.xs;
+    reversed.ys = graph.ys;
+    const int n = graph.numNodes();
+    reversed.offsets.assign(n + 1, 0);
+    for (const int v: graph.targets) {
+        reversed.offsets[v + 1]++;
+    }
+    for (int u = 0; u < n; u++) {
+        reversed.offsets[u + 1] += reversed.offsets[u];
+    }
+    reversed.targets.resize(graph.numEdges());
+    reversed.weights.resize(graph.numEdges());
+    vector<int> cursor(reversed.offsets.begin(), reversed.offsets.end() - 1);
+    for (int u = 0; u < n; u++) {
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            const int slot = cursor[graph.targets[e]]++;
+            reversed.targets[slot] = u;
+            reversed.weights[slot] = graph.weights[e];
+        }
+    }
+    return reversed;
+}
+
+// copy into another weight type and direction policy; false if a weight does not fit in Weight
+template <typename Weight, typename Direction>
+bool convertGraph(const CompactGraph& in, BasicGraph<Weight, Direction>& out) {
+    for (const int w: in.weights) {
+        if (w < numeric_limits<Weight>::lowest() || w > numeric_limits<Weight>::max()) return false;
+    }
+    out = BasicGraph<Weight, Direction>{};
+    out.xs = in.xs;
+    out.ys = in.ys;
+    const int n = in.numNodes();
+    out.offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; u++) {
+        for (int e = in.offsets[u]; e < in.offsets[u + 1]; e++) {
+            out.offsets[u + 1]++;
+            if constexpr (Direction::undirected) out.offsets[in.targets[e] + 1]++;
+        }
+    }
+    for (int u = 0; u < n; u++) {
+        out.offsets[u + 1] += out.offsets[u];
+    }
+    out.targets.resize(out.offsets[n]);
+    out.weights.resize(out.offsets[n]);
+    vector<int> cursor(out.offsets.begin(), out.offsets.end() - 1);
+    for (int u = 0; u < n; u++) {
+        for (int e = in.offsets[u]; e < in.offsets[u + 1]; e++) {
+            const int v = in.targets[e];
+            int slot = cursor[u]++;
+            out.targets[slot] = v;
+            out.weights[slot] = static_cast<Weight>(in.weights[e]);
+            if constexpr (Direction::undirected) {
+                slot = cursor[v]++;
+                out.targets[slot] = u;
+                out.weights[slot] = static_cast<Weight>(in.weights[e]);
+            }
+        }
+    }
+    return true;
+}
+
+// text format, one record per line, '#' starts a comment:
+//   p <numNodes> <numEdges>
+//   v <x> <y>          optional, one per node in index order
+//   e <from> <to> <weight>
+bool loadGraph(const string& path, CompactGraph& graph, string& error);
+bool saveGraph(const string& path, const CompactGraph& graph);
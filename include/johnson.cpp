@@ -0,0 +1,35 @@
+#include "johnson.h"
+#include "engine.h"
+
+bool JohnsonPotentials::update(const NodeStore& nodes, const EdgeMap& edgeData) {
+    if (valid) return !negativeCycle;
+
+    vector<int> indexToSlot;
+    const CompactGraph graph = snapshotGraph(nodes, edgeData, indexToSlot);
+    vector<long long> byIndex;
+    negativeCycle = !computePotentials(graph, byIndex);
+    h.assign(nodes.capacity(), 0);
+    for (int i = 0; i < static_cast<int>(indexToSlot.size()); i++) {
+        h[indexToSlot[i]] = byIndex[i];
+    }
+    valid = true;
+    return !negativeCycle;
+}
+
+void JohnsonPotentials::edgeChanged(const int from, const int to, const int weight) {
+    // after a negative cycle h is meaningless, and the edit may have broken the cycle
+    if (valid && (negativeCycle || reducedWeight(from, to, weight) < 0)) invalidate();
+}
+
+void JohnsonPotentials::nodeAdded(const int slot) {
+    // a new node has no edges yet, so h = 0 keeps every constraint; a reused slot must drop its old value
+    if (slot < static_cast<int>(h.size())) h[slot] = 0;
+}
+
+void JohnsonPotentials::edgesRemoved() {
+    if (negativeCycle) invalidate();
+}
+
+void JohnsonPotentials::invalidate() {
+    valid = false;
+}
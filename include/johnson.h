@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include "nodestore.h"
+using namespace std;
+
+// johnson's vertex potentials for the editor graph, indexed by node slot
+// they stay valid across edits that keep every reduced cost w + h[u] - h[v] non negative,
+// so bellman-ford only reruns when an edit actually breaks that
+class JohnsonPotentials {
+public:
+    // make sure the potentials match the graph; false if the graph has a negative cycle
+    bool update(const NodeStore& nodes, const EdgeMap& edgeData);
+
+    // edit hooks, called by every mutation of the editor graph
+    void edgeChanged(int from, int to, int weight); // edge added or reweighted
+    void nodeAdded(int slot);
+    void edgesRemoved(); // node or edge deletion, can only break a negative cycle
+    void invalidate(); // anything else, e.g. a regenerated graph
+
+    long long potential(int slot) const { return slot < static_cast<int>(h.size()) ? h[slot] : 0; }
+    long long reducedWeight(int from, int to, int weight) const { return weight + potential(from) - potential(to); }
+
+private:
+    vector<long long> h;
+    bool valid = false;
+    bool negativeCycle = false;
+};
@@ -0,0 +1,354 @@
+#include "layout.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "parallel.h"
+#include "profiler.h"
+
+namespace {
+
+constexpr int leafSize = 8; // bodies per quadtree leaf before it is split
+constexpr int maxDepth = 24; // stops splitting piles of (nearly) coincident nodes
+constexpr float cooling = 0.95f; // temperature factor per iteration
+constexpr float minTemperature = 0.5f; // below this nothing moves visibly, so the layout stops
+constexpr int spacingPasses = 2;
+constexpr int finalSpacingPasses = 100;
+
+// split [0, count) into a few chunks per worker; fn(begin, end) runs on the pool
+template <typename Fn>
+void forChunks(WorkerPool& pool, const int count, Fn&& fn) {
+    const int numChunks = min(count, pool.size() * 8);
+    if (numChunks <= 0) return;
+    pool.run(numChunks, [&](int, const int chunk) {
+        fn(static_cast<int>(static_cast<long long>(count) * chunk / numChunks),
+           static_cast<int>(static_cast<long long>(count) * (chunk + 1) / numChunks));
+    });
+}
+
+}
+
+ForceLayout::ForceLayout(const int numThreads)
+    : pool(make_unique<WorkerPool>(numThreads > 0 ? numThreads : defaultThreadCount())) {}
+
+void ForceLayout::start(const NodeStore& nodes, const EdgeMap& edgeData, const long long version, const LayoutParams& layoutParams) {
+    params = layoutParams;
+    snapshot(nodes, edgeData, version);
+    const int n = static_cast<int>(indexToSlot.size());
+    active = n > 1;
+    if (!active) return;
+
+    float minX = nodes.position(indexToSlot[0]).x, maxX = minX;
+    float minY = nodes.position(indexToSlot[0]).y, maxY = minY;
+    for (const int slot: indexToSlot) {
+        minX = min(minX, nodes.position(slot).x);
+        maxX = max(maxX, nodes.position(slot).x);
+        minY = min(minY, nodes.position(slot).y);
+        maxY = max(maxY, nodes.position(slot).y);
+    }
+    if (params.bounded) {
+        minX = params.minX;
+        maxX = params.maxX;
+        minY = params.minY;
+        maxY = params.maxY;
+    }
+
+    // fruchterman-reingold's k = sqrt(area / n), but never closer than the spacing rule allows
+    const float minSpacing = 2 * maxRadius + params.gap;
+    k = params.idealLength;
+    if (k <= 0) {
+        const float area = max(maxX - minX, 1.f) * max(maxY - minY, 1.f);
+        k = params.bounded ? sqrt(area / n) : 2 * minSpacing;
+    }
+    k = max(k, 1.2f * minSpacing);
+    temperature = max(0.1f * max(maxX - minX, maxY - minY), k);
+}
+
+void ForceLayout::snapshot(const NodeStore& nodes, const EdgeMap& edgeData, const long long version) {
+    PROFILE_SCOPE("layout snapshot");
+    const CompactGraph graph = snapshotGraph(nodes, edgeData, indexToSlot, &slotToIndex);
+    convertGraph(graph, adjacency); // int weights always fit
+    adjacency.xs.clear(); // positions are read from the node store every step
+    adjacency.ys.clear();
+    graphVersion = version;
+
+    const int n = static_cast<int>(indexToSlot.size());
+    xs.resize(n);
+    ys.resize(n);
+    radii.resize(n);
+    dispX.resize(n);
+    dispY.resize(n);
+    maxRadius = 0;
+    for (int i = 0; i < n; i++) {
+        radii[i] = nodes.radius(indexToSlot[i]);
+        maxRadius = max(maxRadius, radii[i]);
+    }
+}
+
+void ForceLayout::step(NodeStore& nodes, const EdgeMap& edgeData, const long long version, const int pinned) {
+    if (!active) return;
+    PROFILE_SCOPE("layout step");
+    if (version != graphVersion) snapshot(nodes, edgeData, version);
+    const int n = static_cast<int>(indexToSlot.size());
+    if (n < 2) {
+        active = false;
+        return;
+    }
+    const int pinnedIndex = pinned >= 0 && pinned < static_cast<int>(slotToIndex.size()) ? slotToIndex[pinned] : -1;
+
+    for (int i = 0; i < n; i++) {
+        xs[i] = nodes.position(indexToSlot[i]).x;
+        ys[i] = nodes.position(indexToSlot[i]).y;
+    }
+
+    buildTree();
+    accumulateForces(pinnedIndex);
+    {
+        PROFILE_SCOPE("layout move");
+        forChunks(*pool, n, [&](const int begin, const int end) {
+            for (int i = begin; i < end; i++) {
+                if (i == pinnedIndex) continue;
+                const float length = sqrt(dispX[i] * dispX[i] + dispY[i] * dispY[i]);
+                if (length == 0) continue;
+                const float scale = min(length, temperature) / length; // never move further than the temperature
+                xs[i] += dispX[i] * scale;
+                ys[i] += dispY[i] * scale;
+            }
+        });
+    }
+    clampToBounds(pinnedIndex);
+    temperature *= cooling;
+    if (temperature < minTemperature) active = false;
+
+    // a couple of spacing passes per iteration keep up with the moves, the last iteration clears every overlap left
+    const int passes = active ? spacingPasses : finalSpacingPasses;
+    for (int pass = 0; pass < passes && separate(pinnedIndex); pass++) {
+        clampToBounds(pinnedIndex);
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (i != pinnedIndex) nodes.setPosition(indexToSlot[i], {xs[i], ys[i]});
+    }
+}
+
+void ForceLayout::buildTree() {
+    PROFILE_SCOPE("layout quadtree");
+    const int n = static_cast<int>(xs.size());
+    const auto [minX, maxX] = minmax_element(xs.begin(), xs.end());
+    const auto [minY, maxY] = minmax_element(ys.begin(), ys.end());
+    const float rootX = (*minX + *maxX) / 2;
+    const float rootY = (*minY + *maxY) / 2;
+    const float halfSize = max(*maxX - *minX, *maxY - *minY) / 2 + 1;
+    centerX = params.bounded ? (params.minX + params.maxX) / 2 : rootX;
+    centerY = params.bounded ? (params.minY + params.maxY) / 2 : rootY;
+
+    order.resize(n);
+    iota(order.begin(), order.end(), 0);
+    cells.clear();
+    cells.reserve(n / 2 + 1);
+    cells.emplace_back();
+    fillCell(0, 0, n, rootX, rootY, halfSize, 0);
+
+    // positions in tree order, so leaves read contiguous memory
+    treeX.resize(n);
+    treeY.resize(n);
+    for (int b = 0; b < n; b++) {
+        treeX[b] = xs[order[b]];
+        treeY[b] = ys[order[b]];
+    }
+}
+
+void ForceLayout::fillCell(const int index, const int begin, const int end, const float cellX, const float cellY, const float halfSize, const int depth) {
+    // cells may reallocate while children are built, so always go through cells[index]
+    cells[index].centerX = cellX;
+    cells[index].centerY = cellY;
+    cells[index].halfSize = halfSize;
+    cells[index].begin = begin;
+    cells[index].end = end;
+
+    float mass = 0, massX = 0, massY = 0;
+    if (end - begin <= leafSize || depth >= maxDepth) {
+        for (int b = begin; b < end; b++) {
+            massX += xs[order[b]];
+            massY += ys[order[b]];
+        }
+        mass = static_cast<float>(end - begin);
+    } else {
+        // quadrants in order top-left, top-right, bottom-left, bottom-right
+        auto first = order.begin();
+        const int mid = static_cast<int>(partition(first + begin, first + end, [&](const int i) { return ys[i] < cellY; }) - first);
+        const int splitTop = static_cast<int>(partition(first + begin, first + mid, [&](const int i) { return xs[i] < cellX; }) - first);
+        const int splitBottom = static_cast<int>(partition(first + mid, first + end, [&](const int i) { return xs[i] < cellX; }) - first);
+        const int bounds[5] = {begin, splitTop, mid, splitBottom, end};
+        const float quarter = halfSize / 2;
+
+        const int firstChild = static_cast<int>(cells.size());
+        cells[index].firstChild = firstChild;
+        cells.resize(cells.size() + 4);
+        for (int c = 0; c < 4; c++) {
+            fillCell(firstChild + c, bounds[c], bounds[c + 1],
+                     cellX + (c % 2 ? quarter : -quarter), cellY + (c / 2 ? quarter : -quarter), quarter, depth + 1);
+            const Cell& child = cells[firstChild + c];
+            mass += child.mass;
+            massX += child.massX * child.mass;
+            massY += child.massY * child.mass;
+        }
+    }
+    cells[index].mass = mass;
+    cells[index].massX = mass > 0 ? massX / mass : cellX;
+    cells[index].massY = mass > 0 ? massY / mass : cellY;
+}
+
+void ForceLayout::accumulateForces(const int pinnedIndex) {
+    PROFILE_SCOPE("layout forces");
+    const int n = static_cast<int>(xs.size());
+    const float k2 = params.repulsion * k * k;
+    const float theta2 = params.theta * params.theta;
+    forChunks(*pool, n, [&](const int begin, const int end) {
+        int stack[4 * maxDepth + 8];
+        // bodies are visited in quadtree order, so neighbouring iterations walk the same cells
+        for (int o = begin; o < end; o++) {
+            const int i = order[o];
+            if (i == pinnedIndex) continue;
+            const float x = xs[i], y = ys[i];
+            float fx = 0, fy = 0;
+
+            // repulsion c k^2 / d from every other node, whole cells at once when they look small enough from here
+            int top = 0;
+            stack[top++] = 0;
+            while (top > 0) {
+                const Cell& cell = cells[stack[--top]];
+                if (cell.mass == 0) continue;
+                if (cell.firstChild == -1) {
+                    for (int b = cell.begin; b < cell.end; b++) {
+                        const float dx = x - treeX[b], dy = y - treeY[b];
+                        const float d2 = dx * dx + dy * dy;
+                        // skips itself; coincident nodes are pushed apart by the spacing pass
+                        const float scale = d2 > 0 ? k2 / d2 : 0;
+                        fx += dx * scale;
+                        fy += dy * scale;
+                    }
+                    continue;
+                }
+                const float dx = x - cell.massX, dy = y - cell.massY;
+                const float d2 = dx * dx + dy * dy;
+                const float size = 2 * cell.halfSize;
+                if (size * size < theta2 * d2) {
+                    fx += dx * k2 * cell.mass / d2;
+                    fy += dy * k2 * cell.mass / d2;
+                } else {
+                    for (int c = 0; c < 4; c++) stack[top++] = cell.firstChild + c;
+                }
+            }
+
+            // attraction d^2 / k along every edge, in either direction
+            for (int e = adjacency.offsets[i]; e < adjacency.offsets[i + 1]; e++) {
+                const int j = adjacency.targets[e];
+                const float dx = xs[j] - x, dy = ys[j] - y;
+                const float d = sqrt(dx * dx + dy * dy);
+                fx += dx * d / k;
+                fy += dy * d / k;
+            }
+
+            fx += params.gravity * (centerX - x);
+            fy += params.gravity * (centerY - y);
+            dispX[i] = fx;
+            dispY[i] = fy;
+        }
+    });
+    if (pinnedIndex != -1) {
+        dispX[pinnedIndex] = 0;
+        dispY[pinnedIndex] = 0;
+    }
+}
+
+// push apart nodes closer than radius + radius + gap, checking only nodes in neighbouring grid cells
+// false if no two nodes were too close
+bool ForceLayout::separate(const int pinnedIndex) {
+    PROFILE_SCOPE("layout spacing");
+    const int n = static_cast<int>(xs.size());
+    const float originX = *min_element(xs.begin(), xs.end());
+    const float originY = *min_element(ys.begin(), ys.end());
+
+    // cells as wide as the largest spacing, hashed into a table so spread out layouts need no huge grid
+    // cells sharing a bucket only cost a few extra distance checks
+    const float cellSize = 2 * maxRadius + params.gap;
+    unsigned tableSize = 1;
+    while (tableSize < 2u * n) tableSize *= 2;
+    auto cellOf = [&](const float v, const float origin) { return static_cast<int>((v - origin) / cellSize); };
+    auto bucketOf = [&](const int cx, const int cy) {
+        return (static_cast<unsigned>(cx) * 73856093u ^ static_cast<unsigned>(cy) * 19349663u) & (tableSize - 1);
+    };
+
+    // counting sort of the nodes by bucket
+    gridStart.assign(tableSize + 1, 0);
+    for (int i = 0; i < n; i++) {
+        gridStart[bucketOf(cellOf(xs[i], originX), cellOf(ys[i], originY)) + 1]++;
+    }
+    partial_sum(gridStart.begin(), gridStart.end(), gridStart.begin());
+    gridBodies.resize(n);
+    vector<int> cursor(gridStart.begin(), gridStart.end() - 1);
+    gridX.resize(n);
+    gridY.resize(n);
+    for (int i = 0; i < n; i++) {
+        const int b = cursor[bucketOf(cellOf(xs[i], originX), cellOf(ys[i], originY))]++;
+        gridBodies[b] = i;
+        gridX[b] = xs[i];
+        gridY[b] = ys[i];
+    }
+
+    // every node computes its own push from the old positions, so threads never write the same entry
+    const float maxSpacing = cellSize;
+    forChunks(*pool, n, [&](const int begin, const int end) {
+        for (int o = begin; o < end; o++) { // bucket order keeps neighbouring iterations on the same buckets
+            const int i = gridBodies[o];
+            dispX[i] = 0;
+            dispY[i] = 0;
+            if (i == pinnedIndex) continue;
+            const int cx = cellOf(xs[i], originX), cy = cellOf(ys[i], originY);
+            unsigned seen[9];
+            int numSeen = 0;
+            for (int y = cy - 1; y <= cy + 1; y++) {
+                for (int x = cx - 1; x <= cx + 1; x++) {
+                    const unsigned bucket = bucketOf(x, y);
+                    if (find(seen, seen + numSeen, bucket) != seen + numSeen) continue; // two neighbour cells in one bucket
+                    seen[numSeen++] = bucket;
+                    for (int b = gridStart[bucket]; b < gridStart[bucket + 1]; b++) {
+                        const int j = gridBodies[b];
+                        if (j == i) continue;
+                        float dx = xs[i] - gridX[b], dy = ys[i] - gridY[b];
+                        if (dx * dx + dy * dy >= maxSpacing * maxSpacing) continue;
+                        const float minDist = radii[i] + radii[j] + params.gap;
+                        float d = sqrt(dx * dx + dy * dy);
+                        if (d >= minDist) continue;
+                        if (d < 1e-3f) { // same spot, split them sideways by index
+                            dx = i < j ? -1.f : 1.f;
+                            dy = 0;
+                            d = 1;
+                        }
+                        // each side moves half the overlap, a pinned neighbour does not move at all
+                        // a little extra so the pair ends up clear of the limit rather than exactly on it
+                        const float share = (minDist - d + 0.01f) / (j == pinnedIndex ? 1 : 2);
+                        dispX[i] += dx / d * share;
+                        dispY[i] += dy / d * share;
+                    }
+                }
+            }
+        }
+    });
+    bool moved = false;
+    for (int i = 0; i < n; i++) {
+        xs[i] += dispX[i];
+        ys[i] += dispY[i];
+        moved = moved || dispX[i] != 0 || dispY[i] != 0;
+    }
+    return moved;
+}
+
+void ForceLayout::clampToBounds(const int pinnedIndex) {
+    if (!params.bounded) return;
+    for (int i = 0; i < static_cast<int>(xs.size()); i++) {
+        if (i == pinnedIndex) continue;
+        xs[i] = clamp(xs[i], params.minX, params.maxX);
+        ys[i] = clamp(ys[i], params.minY, params.maxY);
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "graph.h"
+#include "nodestore.h"
+#include "workerpool.h"
+using namespace std;
+
+struct LayoutParams {
+    float idealLength = 0.f; // preferred edge length, 0 = derived from the bounds and node count
+    float gap = 7.f; // space kept between node outlines, the same rule dragging enforces
+    float theta = 0.9f; // barnes-hut opening ratio, larger is faster but coarser
+    float repulsion = 0.3f; // scales the k^2 / d push between nodes, lower packs them tighter
+    float gravity = 0.5f; // pull towards the centre so separate components stay close and walls are not crowded
+    bool bounded = false; // keep every node inside [minX, maxX] x [minY, maxY]
+    float minX = 0.f, minY = 0.f, maxX = 0.f, maxY = 0.f;
+};
+
+// fruchterman-reingold force directed layout, one iteration per step() so the window stays responsive
+// repulsion is approximated with a barnes-hut quadtree (o(n log n) per iteration) and forces are summed in parallel
+class ForceLayout {
+public:
+    explicit ForceLayout(int numThreads = 0);
+
+    // (re)start from the current positions with a hot temperature
+    void start(const NodeStore& nodes, const EdgeMap& edgeData, long long version, const LayoutParams& params);
+    void stop() { active = false; }
+    bool running() const { return active; }
+
+    // move every live node except pinned (e.g. the one being dragged); picks up edits when version changed
+    // stops by itself once the temperature has cooled down
+    void step(NodeStore& nodes, const EdgeMap& edgeData, long long version, int pinned = -1);
+
+private:
+    struct Cell {
+        float centerX, centerY, halfSize; // square covered by the cell
+        float massX = 0, massY = 0; // centre of mass
+        float mass = 0;
+        int firstChild = -1; // 4 children stored together, -1 for a leaf
+        int begin = 0, end = 0; // bodies of the cell in order[]
+    };
+
+    void snapshot(const NodeStore& nodes, const EdgeMap& edgeData, long long version);
+    void buildTree();
+    void fillCell(int index, int begin, int end, float cellX, float cellY, float halfSize, int depth);
+    void accumulateForces(int pinnedIndex);
+    bool separate(int pinnedIndex);
+    void clampToBounds(int pinnedIndex);
+
+    LayoutParams params;
+    unique_ptr<WorkerPool> pool;
+    bool active = false;
+    float temperature = 0; // max distance a node may move in one iteration
+    float k = 0; // ideal edge length
+    float maxRadius = 0;
+    float centerX = 0, centerY = 0; // gravity pulls towards this point
+    long long graphVersion = -1;
+
+    BasicGraph<int, Undirected> adjacency; // both directions of every edge, so a node only writes its own force
+    vector<int> indexToSlot;
+    vector<int> slotToIndex;
+    vector<float> xs, ys; // dense positions, copied from the node store every step so drags are picked up
+    vector<float> radii;
+    vector<float> dispX, dispY;
+    vector<Cell> cells;
+    vector<int> order; // body indices grouped by quadtree cell
+    vector<float> treeX, treeY; // positions in that order
+    vector<int> gridStart, gridBodies; // spatial hash for the spacing pass
+    vector<float> gridX, gridY;
+};
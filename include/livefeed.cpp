@@ -0,0 +1,164 @@
+#include "livefeed.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include "profiler.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+bool parseEdgeUpdate(const string& line, EdgeUpdate& update) {
+    istringstream fields(line);
+    string kind;
+    if (!(fields >> kind) || kind[0] == '#') return false;
+    if (kind == "w" || kind == "e") {
+        update.kind = kind == "w" ? SetWeight : InsertEdge;
+        // same range the mouse wheel allows, getEdgeColor has no colour for anything else
+        return fields >> update.from >> update.to >> update.weight && update.weight >= -5 && update.weight <= 5 && update.weight != 0;
+    }
+    if (kind == "d") {
+        update.kind = DeleteEdge;
+        update.weight = 0;
+        return static_cast<bool>(fields >> update.from >> update.to);
+    }
+    return false;
+}
+
+#ifdef _WIN32
+
+bool LiveFeed::start(const string&) {
+    cout << "the live feed needs a posix named pipe, not available on this platform" << endl;
+    return false;
+}
+
+void LiveFeed::stop() {}
+
+void LiveFeed::readLoop() {}
+
+#else
+
+bool LiveFeed::start(const string& path) {
+    if (running()) return true;
+    if (mkfifo(path.c_str(), 0600) != 0 && errno != EEXIST) {
+        cout << "could not create pipe " << path << endl;
+        return false;
+    }
+    struct stat info{};
+    if (stat(path.c_str(), &info) != 0 || !S_ISFIFO(info.st_mode)) {
+        cout << path << " exists and is not a named pipe" << endl;
+        return false;
+    }
+    // non blocking so opening does not wait for a writer and stop() is noticed while idle
+    readFd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+    keepAliveFd = readFd == -1 ? -1 : open(path.c_str(), O_WRONLY | O_NONBLOCK);
+    if (readFd == -1 || keepAliveFd == -1) {
+        cout << "could not open pipe " << path << endl;
+        stop();
+        return false;
+    }
+    stopping = false;
+    reader = thread(&LiveFeed::readLoop, this);
+    return true;
+}
+
+void LiveFeed::stop() {
+    stopping = true;
+    if (reader.joinable()) reader.join();
+    if (readFd != -1) close(readFd);
+    if (keepAliveFd != -1) close(keepAliveFd);
+    readFd = -1;
+    keepAliveFd = -1;
+    if (malformedLines > 0) cout << "live feed skipped " << malformedLines << " malformed lines" << endl;
+    malformedLines = 0;
+}
+
+void LiveFeed::readLoop() {
+    string pending; // bytes after the last complete line
+    char buffer[64 * 1024];
+    while (!stopping) {
+        pollfd request{readFd, POLLIN, 0};
+        if (poll(&request, 1, 100) <= 0) continue; // timeout so stopping is checked
+        const ssize_t count = read(readFd, buffer, sizeof(buffer));
+        if (count <= 0) continue;
+        pending.append(buffer, count);
+
+        size_t lineStart = 0;
+        for (size_t lineEnd; (lineEnd = pending.find('\n', lineStart)) != string::npos; lineStart = lineEnd + 1) {
+            EdgeUpdate update{};
+            const string line = pending.substr(lineStart, lineEnd - lineStart);
+            if (!parseEdgeUpdate(line, update)) {
+                const size_t first = line.find_first_not_of(" \t\r");
+                if (first != string::npos && line[first] != '#') malformedLines++; // blank lines and comments are fine
+                continue;
+            }
+            // a full queue means the frame loop is behind; wait for it rather than drop updates
+            while (!queue.push(update) && !stopping) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        }
+        pending.erase(0, lineStart);
+    }
+}
+
+#endif
+
+int LiveFeed::drain(vector<EdgeUpdate>& out) {
+    int count = 0;
+    EdgeUpdate update;
+    while (queue.pop(update)) {
+        out.push_back(update);
+        count++;
+    }
+    return count;
+}
+
+int applyEdgeUpdates(const NodeStore& nodes, EdgeMap& edgeData, vector<EdgeUpdate>& batch, JohnsonPotentials& potentials) {
+    PROFILE_SCOPE("applyEdgeUpdates");
+    // group updates by edge, keeping arrival order inside a group
+    stable_sort(batch.begin(), batch.end(), [](const EdgeUpdate& a, const EdgeUpdate& b) {
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    });
+
+    int changed = 0;
+    for (size_t groupStart = 0, groupEnd; groupStart < batch.size(); groupStart = groupEnd) {
+        const int from = batch[groupStart].from;
+        const int to = batch[groupStart].to;
+        groupEnd = groupStart;
+        while (groupEnd < batch.size() && batch[groupEnd].from == from && batch[groupEnd].to == to) groupEnd++;
+        if (from == to || !nodes.isAlive(from) || !nodes.isAlive(to)) continue;
+
+        // replay the group on the edge's state to get its net effect
+        auto& fromEdges = edgeData[from];
+        auto edge = find_if(fromEdges.begin(), fromEdges.end(), [to](const auto& e) { return get<0>(e) == to; });
+        bool exists = edge != fromEdges.end();
+        int weight = exists ? get<1>(*edge) : 0;
+        for (size_t i = groupStart; i < groupEnd; i++) {
+            if (batch[i].kind == DeleteEdge) {
+                exists = false;
+            } else if (batch[i].kind == InsertEdge || exists) {
+                exists = true;
+                weight = batch[i].weight;
+            }
+        }
+
+        if (edge != fromEdges.end() && !exists) {
+            fromEdges.erase(edge);
+            potentials.edgesRemoved();
+        } else if (edge == fromEdges.end() && exists) {
+            fromEdges.emplace_back(to, weight, 1);
+            potentials.edgeChanged(from, to, weight);
+        } else if (exists && get<1>(*edge) != weight) {
+            get<1>(*edge) = weight;
+            potentials.edgeChanged(from, to, weight);
+        } else {
+            continue;
+        }
+        changed++;
+    }
+    return changed;
+}
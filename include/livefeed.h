@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nodestore.h"
+#include "johnson.h"
+using namespace std;
+
+enum EdgeUpdateKind : uint8_t {
+    SetWeight, // reweight an existing edge, ignored if there is none
+    InsertEdge, // add the edge, or reweight it if it exists
+    DeleteEdge,
+};
+
+// one line of the feed; nodes are addressed by slot, which is the index in graph.txt until a node is deleted
+struct EdgeUpdate {
+    EdgeUpdateKind kind;
+    int from;
+    int to;
+    int weight;
+};
+
+// single producer single consumer ring buffer; push and pop never lock or block
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    bool push(const T& value) {
+        const size_t tail = writeIndex.load(memory_order_relaxed);
+        if (tail - readIndex.load(memory_order_acquire) == Capacity) return false; // full
+        items[tail & (Capacity - 1)] = value;
+        writeIndex.store(tail + 1, memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value) {
+        const size_t head = readIndex.load(memory_order_relaxed);
+        if (head == writeIndex.load(memory_order_acquire)) return false; // empty
+        value = items[head & (Capacity - 1)];
+        readIndex.store(head + 1, memory_order_release);
+        return true;
+    }
+
+private:
+    vector<T> items = vector<T>(Capacity); // on the heap, a 1 MiB member would overflow main()'s stack on windows
+    alignas(64) atomic<size_t> writeIndex{0}; // own cache lines so producer and consumer don't share one
+    alignas(64) atomic<size_t> readIndex{0};
+};
+
+// reads edge updates from a named pipe on a background thread, one per line:
+//   w <from> <to> <weight>   set the weight of an existing edge
+//   e <from> <to> <weight>   insert an edge (or set its weight)
+//   d <from> <to>            delete an edge
+// weights must be -5..5 and not 0, like edits with the mouse wheel; other lines are counted as malformed and skipped
+// writers may connect and disconnect at any time, e.g. `cat updates.txt > edge_feed`
+class LiveFeed {
+public:
+    ~LiveFeed() { stop(); }
+
+    // create the pipe at path if it does not exist and start reading; false if it can not be opened
+    bool start(const string& path);
+    void stop();
+    bool running() const { return reader.joinable(); }
+
+    // append every update received since the last call to out, returns how many were added
+    int drain(vector<EdgeUpdate>& out);
+
+private:
+    void readLoop();
+
+    SpscQueue<EdgeUpdate, 1 << 16> queue;
+    thread reader;
+    atomic<bool> stopping{false};
+    int readFd = -1;
+    int keepAliveFd = -1; // our own write end, so the pipe does not report eof between writers
+    long long malformedLines = 0;
+};
+
+// parse one feed line; false for blank lines, '#' comments, malformed lines and out of range weights
+bool parseEdgeUpdate(const string& line, EdgeUpdate& update);
+
+// apply a batch to the editor graph, folding every update of one edge into a single change
+// updates naming a free slot or a self loop are skipped; potentials get the same hooks as interactive edits
+// returns the number of edges changed; batch is left sorted by edge
+int applyEdgeUpdates(const NodeStore& nodes, EdgeMap& edgeData, vector<EdgeUpdate>& batch, JohnsonPotentials& potentials);
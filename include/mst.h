@@ -1,5 +1,8 @@
 #pragma once
+#include <SFML/Graphics.hpp>
+#include "nodestore.h"
 
-void kruskal(vector<shared_ptr<Node>>& nodes, unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, RenderWindow& window);
+// without animate the tree is only written to the node and edge states, nothing is drawn or printed
+void kruskal(NodeStore& nodes, EdgeMap& edgeData, RenderWindow& window, bool animate = true);
 
-void prim(vector<shared_ptr<Node>>& nodes, unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, RenderWindow& window);
+void prim(NodeStore& nodes, EdgeMap& edgeData, RenderWindow& window, bool animate = true);
@@ -0,0 +1,89 @@
+#include "nodestore.h"
+#include "profiler.h"
+
+int NodeStore::add(const Vector2f position, const float radius, const nodeState state) {
+    int slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = capacity();
+        xs.push_back(0);
+        ys.push_back(0);
+        radii.push_back(0);
+        nodeStates.push_back(Clear);
+        denseIndex.push_back(-1);
+    }
+    xs[slot] = position.x;
+    ys[slot] = position.y;
+    radii[slot] = radius;
+    nodeStates[slot] = state;
+    denseIndex[slot] = size();
+    live.push_back(slot);
+    return slot;
+}
+
+void NodeStore::remove(const int slot) {
+    if (!isAlive(slot)) return;
+    // swap the last live slot into the removed one's place
+    const int idx = denseIndex[slot];
+    live[idx] = live.back();
+    denseIndex[live[idx]] = idx;
+    live.pop_back();
+    denseIndex[slot] = -1;
+    nodeStates[slot] = Clear;
+    freeSlots.push_back(slot);
+}
+
+void NodeStore::clear() {
+    xs.clear();
+    ys.clear();
+    radii.clear();
+    nodeStates.clear();
+    denseIndex.clear();
+    live.clear();
+    freeSlots.clear();
+}
+
+void NodeStore::reserve(const int count) {
+    xs.reserve(count);
+    ys.reserve(count);
+    radii.reserve(count);
+    nodeStates.reserve(count);
+    denseIndex.reserve(count);
+    live.reserve(count);
+}
+
+int NodeStore::findAt(const Vector2f point) const {
+    PROFILE_SCOPE("NodeStore::findAt");
+    for (const int slot: live) {
+        const float dx = point.x - xs[slot];
+        const float dy = point.y - ys[slot];
+        const float reach = radii[slot] + nodeOutlineThickness;
+        if (dx * dx + dy * dy <= reach * reach) return slot;
+    }
+    return -1;
+}
+
+CompactGraph snapshotGraph(const NodeStore& nodes, const EdgeMap& edgeData, vector<int>& indexToSlot, vector<int>* slotToIndexOut) {
+    PROFILE_SCOPE("snapshotGraph");
+    indexToSlot = nodes.slots();
+    vector<int> localSlotToIndex;
+    vector<int>& slotToIndex = slotToIndexOut ? *slotToIndexOut : localSlotToIndex;
+    slotToIndex.assign(nodes.capacity(), -1);
+    CompactGraph graph;
+    for (int i = 0; i < static_cast<int>(indexToSlot.size()); i++) {
+        slotToIndex[indexToSlot[i]] = i;
+        graph.xs.push_back(nodes.position(indexToSlot[i]).x);
+        graph.ys.push_back(nodes.position(indexToSlot[i]).y);
+    }
+
+    vector<tuple<int, int, int>> edges;
+    for (const auto& [node, currNodeEdges]: edgeData) {
+        for (const auto& e: currNodeEdges) {
+            edges.emplace_back(slotToIndex[node], slotToIndex[get<0>(e)], get<1>(e));
+        }
+    }
+    fillEdges(graph, static_cast<int>(indexToSlot.size()), edges);
+    return graph;
+}
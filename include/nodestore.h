@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <SFML/Graphics.hpp>
+#include "states.h"
+#include "graph.h"
+using namespace sf;
+using namespace std;
+
+constexpr float nodeOutlineThickness = 2.f;
+
+// structure of arrays node storage; a node is referred to by its slot index
+// deleted slots go on a free list and are handed out again by add()
+class NodeStore {
+public:
+    int add(Vector2f position, float radius, nodeState state=Clear);
+    void remove(int slot);
+    void clear();
+    void reserve(int count);
+
+    // slot of the node drawn under point, -1 if there is none
+    int findAt(Vector2f point) const;
+
+    bool isAlive(int slot) const { return slot >= 0 && slot < capacity() && denseIndex[slot] != -1; }
+    int size() const { return static_cast<int>(live.size()); }
+    int capacity() const { return static_cast<int>(denseIndex.size()); } // number of slots, alive or free
+    const vector<int>& slots() const { return live; } // alive slots in insertion order, until a remove swaps one in
+
+    Vector2f position(const int slot) const { return {xs[slot], ys[slot]}; }
+    void setPosition(const int slot, const Vector2f pos) { xs[slot] = pos.x; ys[slot] = pos.y; }
+    float radius(const int slot) const { return radii[slot]; }
+    nodeState& state(const int slot) { return nodeStates[slot]; }
+    nodeState state(const int slot) const { return nodeStates[slot]; }
+
+    // every slot's state, free slots are always Clear; lets state sweeps run as a flat byte scan
+    span<nodeState> states() { return nodeStates; }
+
+private:
+    vector<float> xs;
+    vector<float> ys;
+    vector<float> radii;
+    vector<nodeState> nodeStates;
+    vector<int> denseIndex; // position of the slot in live, -1 when free
+    vector<int> live;
+    vector<int> freeSlots;
+};
+
+// key=node slot, val=<end_node, weight, thickness>
+using EdgeMap = unordered_map<int, vector<tuple<int, int, int>>>;
+
+// copy the live nodes and their edges into a CompactGraph numbered 0..size()-1
+// indexToSlot maps every compact index back to its node slot, slotToIndex the other way (-1 for free slots)
+CompactGraph snapshotGraph(const NodeStore& nodes, const EdgeMap& edgeData, vector<int>& indexToSlot, vector<int>* slotToIndex = nullptr);
@@ -0,0 +1,36 @@
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <vector>
+using namespace std;
+
+inline int defaultThreadCount() {
+    return max(1, static_cast<int>(thread::hardware_concurrency()));
+}
+
+// split [begin, end) into numChunks contiguous chunks and run fn(chunkId, chunkBegin, chunkEnd) on up to numThreads threads
+// chunk boundaries only depend on numChunks, so results stay deterministic whatever the thread count
+template <typename Fn>
+void parallelChunks(const int begin, const int end, const int numChunks, int numThreads, Fn&& fn) {
+    if (end <= begin || numChunks <= 0) return;
+    if (numThreads <= 0) numThreads = defaultThreadCount();
+    numThreads = min(numThreads, numChunks);
+    const long long total = end - begin;
+    auto runChunk = [&](const int chunk) {
+        const int chunkBegin = begin + static_cast<int>(total * chunk / numChunks);
+        const int chunkEnd = begin + static_cast<int>(total * (chunk + 1) / numChunks);
+        if (chunkBegin < chunkEnd) fn(chunk, chunkBegin, chunkEnd);
+    };
+    if (numThreads == 1) {
+        for (int chunk = 0; chunk < numChunks; chunk++) runChunk(chunk);
+        return;
+    }
+
+    vector<thread> workers;
+    for (int t = 0; t < numThreads; t++) {
+        workers.emplace_back([&, t]() {
+            for (int chunk = t; chunk < numChunks; chunk += numThreads) runChunk(chunk);
+        });
+    }
+    for (auto& w: workers) w.join();
+}
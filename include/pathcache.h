@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "engine.h"
+using namespace std;
+
+// lru cache of paused dijkstra searches, keyed by (graph version, source)
+// a query from a cached source walks the stored parents when its target is already settled,
+// otherwise it resumes the saved frontier; memory is bounded by the bytes of the cached searches
+// safe to share between threads, queries on one source take turns
+template <typename Dist>
+class BasicPathCache {
+public:
+    explicit BasicPathCache(const size_t maxBytes = 64u << 20) : maxBytes(maxBytes) {}
+
+    // same result as dijkstraQuery on graph, which must be the graph at version
+    // searches with potentials (johnson) are cached apart from plain ones
+    template <typename Graph, typename Observer = NullObserver>
+    BasicPathResult<Dist> query(const Graph& graph, const long long version, const int startNode, const int endNode,
+                                Observer&& observer = {}, const vector<Dist>* potentials = nullptr) {
+        if (startNode < 0 || startNode >= graph.numNodes()) return {};
+        if (maxBytes == 0) return dijkstraQuery(graph, startNode, endNode, threadWorkspace<Dist>(), observer, potentials);
+
+        const shared_ptr<Entry> entry = acquire({version, startNode, potentials != nullptr});
+        BasicPathResult<Dist> result;
+        {
+            lock_guard<mutex> entryGuard(entry->lock);
+            if (!entry->started) {
+                startDijkstra(graph, startNode, entry->search);
+                entry->started = true;
+            }
+            result = resumeDijkstra(graph, startNode, endNode, entry->search, observer, potentials);
+        }
+
+        lock_guard<mutex> guard(lock);
+        if (entry->cached) {
+            const size_t bytes = entry->search.bytes();
+            usedBytes += bytes - entry->bytes;
+            entry->bytes = bytes;
+            evict();
+        }
+        return result;
+    }
+
+private:
+    struct Key {
+        long long version;
+        int source;
+        bool reweighted;
+        bool operator==(const Key&) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return hash<long long>()(key.version) ^ (hash<int>()(key.source) * 31) ^ key.reweighted;
+        }
+    };
+    struct Entry {
+        Key key;
+        mutex lock; // held while the search is resumed
+        BasicWorkspace<Dist> search;
+        bool started = false;
+        bool cached = true; // false once evicted, a thread may still be using it
+        size_t bytes = 0; // last size booked in usedBytes
+    };
+
+    shared_ptr<Entry> acquire(const Key& key) {
+        lock_guard<mutex> guard(lock);
+        // once a newer version shows up the older searches can never be hit again
+        if (key.version > newestVersion) {
+            newestVersion = key.version;
+            for (auto it = lru.begin(); it != lru.end();) {
+                it = (*it)->key.version < newestVersion ? drop(it) : next(it);
+            }
+        }
+
+        if (auto found = index.find(key); found != index.end()) {
+            lru.splice(lru.begin(), lru, found->second); // most recently used first
+            return lru.front();
+        }
+        shared_ptr<Entry> entry;
+        if (spare && spare.use_count() == 1) {
+            entry = move(spare); // an evicted search's arrays, so starting the new one stays o(1)
+            entry->started = false;
+            entry->cached = true;
+            entry->bytes = 0;
+        } else {
+            entry = make_shared<Entry>();
+        }
+        entry->key = key;
+        lru.push_front(entry);
+        index[key] = lru.begin();
+        return entry;
+    }
+
+    // drop least recently used searches until the cache fits, keeping the arrays of the last one for reuse
+    void evict() {
+        while (usedBytes > maxBytes && !lru.empty()) {
+            drop(prev(lru.end()));
+        }
+    }
+
+    typename list<shared_ptr<Entry>>::iterator drop(const typename list<shared_ptr<Entry>>::iterator it) {
+        shared_ptr<Entry> entry = *it;
+        usedBytes -= entry->bytes;
+        entry->cached = false;
+        index.erase(entry->key);
+        spare = move(entry);
+        return lru.erase(it);
+    }
+
+    mutex lock;
+    list<shared_ptr<Entry>> lru; // most recently used first
+    unordered_map<Key, typename list<shared_ptr<Entry>>::iterator, KeyHash> index;
+    shared_ptr<Entry> spare;
+    const size_t maxBytes; // 0 turns the cache off
+    size_t usedBytes = 0;
+    long long newestVersion = -1;
+};
+
+using PathCache = BasicPathCache<long long>;
@@ -1,9 +1,16 @@
 #pragma once
 #include <vector>
-#include <memory>
 #include <SFML/Graphics.hpp>
 #include "states.h"
+#include "nodestore.h"
+#include "johnson.h"
+#include "pathcache.h"
 
-void findDijkstraPath(vector<shared_ptr<Node>>& nodes, unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, RenderWindow& window, const shared_ptr<Node>& startNode, const shared_ptr<Node>& endNode);
+// with potentials, runs on johnson's reduced costs so negative edge weights are handled
+// searches are kept in cache under version, which has to change with every edit of the graph;
+// only the part of the search not done by earlier queries from the same start node is animated
+// without animate the result is only written to the node and edge states, nothing is drawn or printed
+void findDijkstraPath(NodeStore& nodes, EdgeMap& edgeData, RenderWindow& window, int startNode, int endNode,
+                      long long version, PathCache& cache, const JohnsonPotentials* potentials = nullptr, bool animate = true);
 
-void bellmanFord(vector<shared_ptr<Node>>& nodes, unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, RenderWindow& window, const shared_ptr<Node>& startNode, const shared_ptr<Node>& endNode);
\ No newline at end of file
+void bellmanFord(NodeStore& nodes, EdgeMap& edgeData, RenderWindow& window, int startNode, int endNode, bool animate = true);
\ No newline at end of file
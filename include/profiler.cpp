@@ -0,0 +1,156 @@
+#include "profiler.h"
+#include <algorithm>
+#include <numeric>
+
+FrameHistogram& frameHistogram() {
+    static FrameHistogram histogram;
+    return histogram;
+}
+
+void FrameHistogram::record(const float frameMs) {
+    frames[next] = frameMs;
+    next = (next + 1) % frameWindow;
+    filled = min(filled + 1, frameWindow);
+}
+
+array<int, FrameHistogram::numBuckets> FrameHistogram::counts() const {
+    array<int, numBuckets> buckets{};
+    for (int i = 0; i < filled; i++) {
+        buckets[min(numBuckets - 1, static_cast<int>(frames[i] / bucketMs))]++;
+    }
+    return buckets;
+}
+
+float FrameHistogram::averageMs() const {
+    if (filled == 0) return 0;
+    return accumulate(frames.begin(), frames.begin() + filled, 0.f) / filled;
+}
+
+float FrameHistogram::worstMs() const {
+    if (filled == 0) return 0;
+    return *max_element(frames.begin(), frames.begin() + filled);
+}
+
+#ifdef ENABLE_PROFILER
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    int64_t startUs;
+    int64_t durationUs;
+};
+
+// one ring entry; sequence is the event's index once it is complete, so the dump can tell a torn copy
+// of a slot that was overwritten while it read it
+struct TraceSlot {
+    static constexpr uint64_t rewriting = ~uint64_t{0};
+    atomic<uint64_t> sequence{rewriting};
+    atomic<const char*> name{nullptr};
+    atomic<int64_t> startUs{0};
+    atomic<int64_t> durationUs{0};
+};
+
+// written only by the thread currently holding it; the dump reads whatever has been published through written
+struct RingBuffer {
+    static constexpr size_t capacity = 1 << 16;
+    unique_ptr<TraceSlot[]> events = make_unique<TraceSlot[]>(capacity);
+    atomic<uint64_t> written{0};
+    int threadId = 0;
+};
+
+const chrono::steady_clock::time_point traceEpoch = chrono::steady_clock::now();
+
+mutex registryMutex;
+vector<shared_ptr<RingBuffer>>& registry() { // buffers outlive their threads so late dumps still see them
+    static vector<shared_ptr<RingBuffer>> buffers;
+    return buffers;
+}
+
+vector<shared_ptr<RingBuffer>>& freeBuffers() { // buffers of finished threads, handed to the next new thread
+    static vector<shared_ptr<RingBuffer>> buffers;
+    return buffers;
+}
+
+// a thread's hold on a buffer; short lived threads (e.g. parallelChunks workers) reuse the buffers of finished ones,
+// so the number of buffers is bounded by the most threads alive at once
+struct BufferLease {
+    shared_ptr<RingBuffer> buffer;
+
+    BufferLease() {
+        lock_guard<mutex> lock(registryMutex);
+        if (!freeBuffers().empty()) {
+            buffer = move(freeBuffers().back());
+            freeBuffers().pop_back();
+            return;
+        }
+        buffer = make_shared<RingBuffer>();
+        buffer->threadId = static_cast<int>(registry().size()) + 1;
+        registry().push_back(buffer);
+    }
+
+    ~BufferLease() {
+        lock_guard<mutex> lock(registryMutex);
+        freeBuffers().push_back(move(buffer));
+    }
+};
+
+RingBuffer& threadBuffer() {
+    thread_local BufferLease lease;
+    return *lease.buffer;
+}
+
+int64_t sinceEpochUs(const chrono::steady_clock::time_point t) {
+    return chrono::duration_cast<chrono::microseconds>(t - traceEpoch).count();
+}
+
+}
+
+ScopedTimer::~ScopedTimer() {
+    const auto end = chrono::steady_clock::now();
+    RingBuffer& buffer = threadBuffer();
+    const uint64_t index = buffer.written.load(memory_order_relaxed);
+    TraceSlot& slot = buffer.events[index % RingBuffer::capacity];
+    slot.sequence.store(TraceSlot::rewriting, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release); // a reader that sees the new fields also sees rewriting
+    slot.name.store(name, memory_order_relaxed);
+    slot.startUs.store(sinceEpochUs(start), memory_order_relaxed);
+    slot.durationUs.store(sinceEpochUs(end) - sinceEpochUs(start), memory_order_relaxed);
+    slot.sequence.store(index, memory_order_release);
+    buffer.written.store(index + 1, memory_order_release);
+}
+
+int dumpChromeTrace(const string& path) {
+    ofstream out(path);
+    if (!out) return -1;
+
+    out << "{\"traceEvents\":[";
+    int count = 0;
+    lock_guard<mutex> lock(registryMutex);
+    for (const auto& buffer: registry()) {
+        const uint64_t written = buffer->written.load(memory_order_acquire);
+        const uint64_t first = written > RingBuffer::capacity ? written - RingBuffer::capacity : 0;
+        for (uint64_t i = first; i < written; i++) {
+            // the owner may be overwriting the oldest slots right now; skip any slot that changed while it was copied
+            const TraceSlot& slot = buffer->events[i % RingBuffer::capacity];
+            if (slot.sequence.load(memory_order_acquire) != i) continue;
+            const TraceEvent e{slot.name.load(memory_order_relaxed), slot.startUs.load(memory_order_relaxed),
+                               slot.durationUs.load(memory_order_relaxed)};
+            atomic_thread_fence(memory_order_acquire);
+            if (slot.sequence.load(memory_order_relaxed) != i) continue;
+            out << (count++ ? ",\n" : "\n")
+                << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"ts\":" << e.startUs
+                << ",\"dur\":" << e.durationUs << ",\"pid\":1,\"tid\":" << buffer->threadId << "}";
+        }
+    }
+    out << "\n]}\n";
+    return count;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+using namespace std;
+
+// scoped timers writing into per thread ring buffers, dumped as chrome trace-event json
+// PROFILE_SCOPE compiles to nothing unless ENABLE_PROFILER is defined
+
+#ifdef ENABLE_PROFILER
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name) : name(name), start(chrono::steady_clock::now()) {}
+    ~ScopedTimer();
+
+private:
+    const char* name; // must outlive the profiler, string literals only
+    chrono::steady_clock::time_point start;
+};
+
+// write every buffered event to path, returns the number of events written or -1 on failure
+int dumpChromeTrace(const string& path);
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ScopedTimer PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+#else
+
+inline int dumpChromeTrace(const string&) { return -1; }
+
+#define PROFILE_SCOPE(name) ((void)0)
+
+#endif
+
+// rolling histogram of the last frameWindow frame times
+class FrameHistogram {
+public:
+    static constexpr int frameWindow = 240;
+    static constexpr int numBuckets = 12;
+    static constexpr float bucketMs = 4.f; // last bucket collects everything slower
+
+    void record(float frameMs);
+    array<int, numBuckets> counts() const;
+    float averageMs() const;
+    float worstMs() const;
+
+private:
+    array<float, frameWindow> frames{};
+    int next = 0;
+    int filled = 0;
+};
+
+FrameHistogram& frameHistogram();
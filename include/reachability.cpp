@@ -0,0 +1,56 @@
+#include "reachability.h"
+#include <algorithm>
+
+void ReachabilityIndex::buildClosure() {
+    PROFILE_SCOPE("ReachabilityIndex::buildClosure");
+    rowWords = (components + 63) / 64;
+    closure.clear();
+    if (static_cast<double>(components) * rowWords * sizeof(uint64_t) > maxClosureBytes) return;
+
+    // successors always have lower numbers, so their rows are complete before they are merged into c's
+    closure.assign(components * rowWords, 0);
+    for (int c = 0; c < components; c++) {
+        uint64_t* row = &closure[c * rowWords];
+        row[c / 64] |= uint64_t{1} << (c % 64);
+        for (int e = dagOffsets[c]; e < dagOffsets[c + 1]; e++) {
+            const uint64_t* successor = &closure[dagTargets[e] * rowWords];
+            for (size_t w = 0; w <= static_cast<size_t>(dagTargets[e]) / 64; w++) row[w] |= successor[w];
+        }
+    }
+}
+
+bool ReachabilityIndex::searchCondensation(const int fromComponent, const int toComponent) const {
+    // per thread visit stamps, so concurrent queries need no locking and nothing is cleared between them
+    thread_local vector<unsigned> seen;
+    thread_local unsigned stamp = 0;
+    thread_local vector<int> stack;
+    if (seen.size() < static_cast<size_t>(components)) seen.resize(components, 0);
+    if (++stamp == 0) {
+        fill(seen.begin(), seen.end(), 0);
+        stamp = 1;
+    }
+
+    stack.assign(1, fromComponent);
+    seen[fromComponent] = stamp;
+    while (!stack.empty()) {
+        const int c = stack.back();
+        stack.pop_back();
+        for (int e = dagOffsets[c]; e < dagOffsets[c + 1]; e++) {
+            const int d = dagTargets[e];
+            if (d == toComponent) return true;
+            if (d < toComponent || seen[d] == stamp) continue; // lower numbers can not lead back up to toComponent
+            seen[d] = stamp;
+            stack.push_back(d);
+        }
+    }
+    return false;
+}
+
+bool ReachabilityIndex::reachable(const int from, const int to) const {
+    const int a = componentOf[from];
+    const int b = componentOf[to];
+    if (a == b) return true;
+    if (a < b) return false; // condensation edges only go to lower numbers
+    if (!closure.empty()) return closure[a * rowWords + b / 64] >> (b % 64) & 1;
+    return searchCondensation(a, b);
+}
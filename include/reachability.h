@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "engine.h"
+using namespace std;
+
+// answers "can from reach to" from the strongly connected components and their condensation dag
+// the dag's transitive closure is kept as one bit row per component, so a query is two lookups and a bit test;
+// when the closure would not fit in maxClosureBytes a query searches the condensation instead
+class ReachabilityIndex {
+public:
+    explicit ReachabilityIndex(const size_t maxClosureBytes = 32u << 20) : maxClosureBytes(maxClosureBytes) {}
+
+    template <typename Graph>
+    void build(const Graph& graph);
+
+    // nodes of the last built graph; safe to call from several threads
+    bool reachable(int from, int to) const;
+
+    int numComponents() const { return components; }
+    int component(const int node) const { return componentOf[node]; }
+
+private:
+    void buildClosure();
+    bool searchCondensation(int fromComponent, int toComponent) const;
+
+    size_t maxClosureBytes;
+    int components = 0;
+    vector<int> componentOf;
+    vector<int> dagOffsets{0}; // condensation edges in csr form, one per pair of components
+    vector<int> dagTargets;
+    size_t rowWords = 0;
+    vector<uint64_t> closure; // row c has bit d set when component c reaches d; empty when over budget
+};
+
+template <typename Graph>
+void ReachabilityIndex::build(const Graph& graph) {
+    PROFILE_SCOPE("ReachabilityIndex::build");
+    components = stronglyConnectedComponents(graph, componentOf);
+
+    // group the nodes by component, then collect each component's distinct successors
+    vector<int> memberStart(components + 1, 0);
+    for (const int c: componentOf) memberStart[c + 1]++;
+    for (int c = 0; c < components; c++) memberStart[c + 1] += memberStart[c];
+    vector<int> members(componentOf.size());
+    vector<int> fill(memberStart.begin(), memberStart.end() - 1);
+    for (int u = 0; u < graph.numNodes(); u++) members[fill[componentOf[u]]++] = u;
+
+    vector<int> lastSource(components, -1); // marks successors already added for the current component
+    dagOffsets.assign(1, 0);
+    dagTargets.clear();
+    for (int c = 0; c < components; c++) {
+        for (int m = memberStart[c]; m < memberStart[c + 1]; m++) {
+            const int u = members[m];
+            for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+                const int d = componentOf[graph.targets[e]];
+                if (d == c || lastSource[d] == c) continue;
+                lastSource[d] = c;
+                dagTargets.push_back(d);
+            }
+        }
+        dagOffsets.push_back(static_cast<int>(dagTargets.size()));
+    }
+    buildClosure();
+}
@@ -0,0 +1,63 @@
+#include "runstats.h"
+
+#ifdef ENABLE_RUN_STATS
+
+#include <fstream>
+#include <mutex>
+
+namespace {
+thread_local RunStats current;
+mutex lastMutex;
+RunStats last;
+bool hasLast = false;
+
+void appendJsonLine(const RunStats& stats) {
+    ofstream log("run_stats.jsonl", ios::app);
+    if (!log) return;
+    const auto now = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+    log << "{\"time\":" << now
+        << ",\"algorithm\":\"" << stats.algorithm << "\""
+        << ",\"nodes_settled\":" << stats.nodesSettled
+        << ",\"edges_relaxed\":" << stats.edgesRelaxed
+        << ",\"heap_pushes\":" << stats.heapPushes
+        << ",\"stale_pops\":" << stats.stalePops
+        << ",\"union_find_ops\":" << stats.unionFindOps
+        << ",\"bellman_ford_rounds\":" << stats.bellmanFordRounds
+        << ",\"peak_queue_size\":" << stats.peakQueueSize
+        << ",\"compute_ms\":" << stats.computeMs
+        << ",\"animation_ms\":" << stats.animationMs
+        << "}\n";
+}
+}
+
+RunStats& currentRunStats() {
+    return current;
+}
+
+bool lastRunStats(RunStats& out) {
+    lock_guard<mutex> lock(lastMutex);
+    if (hasLast) out = last;
+    return hasLast;
+}
+
+RunScope::RunScope(const char* algorithm) : start(chrono::steady_clock::now()) {
+    current = RunStats{};
+    current.algorithm = algorithm;
+}
+
+RunScope::~RunScope() {
+    const chrono::duration<double, milli> total = chrono::steady_clock::now() - start;
+    current.computeMs = total.count() - current.animationMs;
+
+    lock_guard<mutex> lock(lastMutex);
+    last = current;
+    hasLast = true;
+    appendJsonLine(current);
+}
+
+AnimationScope::~AnimationScope() {
+    const chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    current.animationMs += elapsed.count();
+}
+
+#endif
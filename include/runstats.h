@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <chrono>
+#include <algorithm>
+using namespace std;
+
+// counters collected while one algorithm run executes
+// only compiled in when ENABLE_RUN_STATS is defined, release builds leave every hook out
+struct RunStats {
+    string algorithm;
+    long long nodesSettled = 0;
+    long long edgesRelaxed = 0; // relaxation attempts, successful or not
+    long long heapPushes = 0;
+    long long stalePops = 0; // heap entries popped after their node was already settled
+    long long unionFindOps = 0;
+    long long bellmanFordRounds = 0;
+    long long peakQueueSize = 0;
+    double computeMs = 0; // wall time of the run minus animationMs
+    double animationMs = 0; // sleeps and redraws done to animate the run
+};
+
+#ifdef ENABLE_RUN_STATS
+
+RunStats& currentRunStats();
+
+// copy of the most recently finished run, false if nothing ran yet
+bool lastRunStats(RunStats& out);
+
+// starts a fresh set of counters on this thread; finishing writes the run to run_stats.jsonl
+class RunScope {
+public:
+    explicit RunScope(const char* algorithm);
+    ~RunScope();
+
+private:
+    chrono::steady_clock::time_point start;
+};
+
+// time spent inside the scope is booked as animation instead of compute time
+class AnimationScope {
+public:
+    AnimationScope() : start(chrono::steady_clock::now()) {}
+    ~AnimationScope();
+
+private:
+    chrono::steady_clock::time_point start;
+};
+
+#define STATS_RUN(algorithm) RunScope statsRunScope(algorithm)
+#define STATS_ANIMATION() AnimationScope statsAnimationScope
+#define STATS_INC(counter) (++currentRunStats().counter)
+#define STATS_ADD(counter, amount) (currentRunStats().counter += (amount))
+#define STATS_PEAK(counter, value) (currentRunStats().counter = max<long long>(currentRunStats().counter, (value)))
+
+#else
+
+#define STATS_RUN(algorithm) ((void)0)
+#define STATS_ANIMATION() ((void)0)
+#define STATS_INC(counter) ((void)0)
+#define STATS_ADD(counter, amount) ((void)0)
+#define STATS_PEAK(counter, value) ((void)0)
+
+#endif
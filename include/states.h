@@ -1,10 +1,7 @@
 #pragma once
-#include <SFML/Graphics.hpp>
-#include <memory>
-using namespace sf;
-using namespace std;
+#include <cstdint>
 
-enum nodeState {
+enum nodeState : uint8_t {
     Clear, // empty node
     Start, // start node
     End, // end node
@@ -14,44 +11,3 @@ enum nodeState {
     CurrentNode, // current node selected from InQueue to be processed
     VisitedNoPath, // visited nodes where a path wasn't found
 };
-
-class UniqueIDGenerator {
-public:
-    static int generateID() {
-        static int counter = 0;
-        return ++counter;
-    }
-};
-
-struct Node {
-    CircleShape node;
-    nodeState state;
-    int id;
-
-    Node(const CircleShape node, const nodeState state=Clear) : node(node), state(state) {
-        id = UniqueIDGenerator::generateID();
-    }
-
-    bool operator==(const Node& other) const {
-        return id == other.id;
-    }
-
-    struct Hash {
-        size_t operator()(const Node& node) const {
-            return hash<int>()(node.id);
-        }
-    };
-};
-
-
-struct NodePtrHash {
-    size_t operator()(const shared_ptr<Node>& nodePtr) const {
-        return hash<int>()(nodePtr->id);
-    }
-};
-
-struct NodePtrEqual {
-    bool operator()(const shared_ptr<Node>& lhs, const shared_ptr<Node>& rhs) const {
-        return lhs->id == rhs->id;
-    }
-};
@@ -2,47 +2,108 @@
 
 #include "window.h"
 #include "states.h"
+#include "runstats.h"
+#include "profiler.h"
 #include <cmath>
+#include <algorithm>
+#include <thread>
+#include <sstream>
+#include <iostream>
 #include <SFML/Graphics.hpp>
 using namespace std;
 
-void drawNodes(vector<shared_ptr<Node>> nodes, RenderWindow& window) {
-    for (auto& n : nodes) {
-        switch (n->state) {
-            case Clear:
-                n->node.setFillColor(Color::White);
-            break;
-            case Start:
-                n->node.setFillColor(Color(255, 0, 0));
-            break;
-            case End:
-                n->node.setFillColor(Color(255, 128, 0));
-            break;
-            case Visited:
-                n->node.setFillColor(Color(175, 238, 238));
-            break;
-            case Path:
-                n->node.setFillColor(Color(204, 153, 255));
-            break;
-            case InQueue:
-                n->node.setFillColor(Color(152, 251, 152));
-            break;
-            case CurrentNode:
-                n->node.setFillColor(Color(178, 102, 255));
-            break;
-            case VisitedNoPath:
-                n->node.setFillColor(Color(192, 192, 192));
-            break;
-            default:
-                n->node.setFillColor(Color::White);
-            break;
+Color getNodeColor(const nodeState state) {
+    switch (state) {
+        case Clear:
+            return Color::White;
+        case Start:
+            return Color(255, 0, 0);
+        case End:
+            return Color(255, 128, 0);
+        case Visited:
+            return Color(175, 238, 238);
+        case Path:
+            return Color(204, 153, 255);
+        case InQueue:
+            return Color(152, 251, 152);
+        case CurrentNode:
+            return Color(178, 102, 255);
+        case VisitedNoPath:
+            return Color(192, 192, 192);
+        default:
+            return Color::White;
+    }
+}
+
+// append a filled circle as a triangle fan flattened into a triangle list
+void appendCircle(VertexArray& vertices, const Vector2f center, const float radius, const Color color, const vector<Vector2f>& unitCircle) {
+    for (size_t i = 0; i < unitCircle.size(); i++) {
+        const Vector2f& a = unitCircle[i];
+        const Vector2f& b = unitCircle[(i + 1) % unitCircle.size()];
+        vertices.append(Vertex(center, color));
+        vertices.append(Vertex(Vector2f(center.x + a.x*radius, center.y + a.y*radius), color));
+        vertices.append(Vertex(Vector2f(center.x + b.x*radius, center.y + b.y*radius), color));
+    }
+}
+
+const vector<int>* componentLabels = nullptr;
+
+void setComponentOverlay(const vector<int>* labels) {
+    componentLabels = labels;
+}
+
+// well spread hues for consecutive component numbers
+Color getComponentColor(const int component) {
+    const float hue = fmod(component * 0.618034f, 1.f) * 6;
+    const float x = 1 - fabs(fmod(hue, 2.f) - 1);
+    float r = 0, g = 0, b = 0;
+    if (hue < 1) { r = 1; g = x; }
+    else if (hue < 2) { r = x; g = 1; }
+    else if (hue < 3) { g = 1; b = x; }
+    else if (hue < 4) { g = x; b = 1; }
+    else if (hue < 5) { r = x; b = 1; }
+    else { r = 1; b = x; }
+    return Color(r*220, g*220, b*220);
+}
+
+// circle geometry is generated from the node store every frame and drawn in a single call
+void drawNodes(const NodeStore& nodes, RenderWindow& window) {
+    PROFILE_SCOPE("drawNodes");
+    static VertexArray vertices(Triangles);
+    static vector<Vector2f> unitCircle;
+    static int segments = 0;
+    vertices.clear();
+
+    const Vector2f windowSize(window.getSize());
+    for (const int n: nodes.slots()) {
+        const Vector2f pos = nodes.position(n);
+        const float outerRadius = nodes.radius(n) + nodeOutlineThickness;
+        if (pos.x + outerRadius < 0 || pos.y + outerRadius < 0 || pos.x - outerRadius > windowSize.x || pos.y - outerRadius > windowSize.y) continue;
+
+        const int wantedSegments = clamp(static_cast<int>(outerRadius * 2), 8, 30); // CircleShape default is 30
+        if (wantedSegments != segments) {
+            segments = wantedSegments;
+            unitCircle.clear();
+            for (int i = 0; i < segments; i++) {
+                const float angle = 2 * M_PI * i / segments;
+                unitCircle.emplace_back(cos(angle), sin(angle));
+            }
+        }
+        if (componentLabels && n < static_cast<int>(componentLabels->size()) && (*componentLabels)[n] >= 0) {
+            appendCircle(vertices, pos, outerRadius + 3, getComponentColor((*componentLabels)[n]), unitCircle);
         }
-        window.draw(n->node);
+        appendCircle(vertices, pos, outerRadius, Color::Black, unitCircle); // outline
+        appendCircle(vertices, pos, nodes.radius(n), getNodeColor(nodes.state(n)), unitCircle);
     }
+    window.draw(vertices);
 }
 
 
 Color getEdgeColor(int weight) {
+    if (weight < 0) { // darker shade of the positive weight's colour
+        Color c = getEdgeColor(-weight);
+        return Color(c.r/2, c.g/2, c.b/2);
+    }
     switch(weight) {
         case 1:
             return Color::Red;
@@ -60,15 +121,16 @@ Color getEdgeColor(int weight) {
 }
 
 // draw arrowheads to show edge direction
-void drawArrowheads(const unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, RenderWindow& window) {
+void drawArrowheads(const NodeStore& nodes, const EdgeMap& edgeData, RenderWindow& window) {
+    PROFILE_SCOPE("drawArrowheads");
     vector<ConvexShape> arrowheads{};
 
     for (auto& [node, currNodeEdges] : edgeData) {
         int i = 0;
         for (auto& e: currNodeEdges) {
-            Vector2f point1 = get<0>(e)->node.getPosition();
-            Vector2f point2 = node->node.getPosition();
-            const int nodeRadius = get<0>(e)->node.getRadius() + 4; // +4 for border
+            Vector2f point1 = nodes.position(get<0>(e));
+            Vector2f point2 = nodes.position(node);
+            const int nodeRadius = nodes.radius(get<0>(e)) + 4; // +4 for border
 
             // Calculate the angle between point1 and point2
             float dx = point2.x - point1.x;
@@ -99,9 +161,9 @@ void drawArrowheads(const unordered_map<shared_ptr<Node>, vector<tuple<shared_pt
     }
 }
 
-RectangleShape getShapeForEdge(const shared_ptr<Node>& startNode, const shared_ptr<Node>& endNode, const int weight, const int thickness) {
-    Vector2f startPos = startNode->node.getPosition();
-    Vector2f endPos = endNode->node.getPosition();
+RectangleShape getShapeForEdge(const NodeStore& nodes, const int startNode, const int endNode, const int weight, const int thickness) {
+    Vector2f startPos = nodes.position(startNode);
+    Vector2f endPos = nodes.position(endNode);
     float distance = sqrt(pow(endPos.x - startPos.x, 2) + pow(endPos.y - startPos.y, 2));
     RectangleShape line(Vector2f(distance, thickness));
     line.setPosition(startPos);
@@ -111,18 +173,113 @@ RectangleShape getShapeForEdge(const shared_ptr<Node>& startNode, const shared_p
     return line;
 }
 
-void refreshScreen(const vector<shared_ptr<Node>>& nodes, const unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, RenderWindow& window) {
+void refreshScreen(const NodeStore& nodes, const EdgeMap& edgeData, RenderWindow& window) {
+    PROFILE_SCOPE("refreshScreen");
+    STATS_ANIMATION();
     window.clear(Color::White);
 
     // draw edges
-    for (auto& [node, currNodeEdges] : edgeData) {
-        for (auto& e: currNodeEdges) {
-            RectangleShape edgeShape = getShapeForEdge(node, get<0>(e), get<1>(e), get<2>(e));
-            window.draw(edgeShape);
+    {
+        PROFILE_SCOPE("drawEdges (getShapeForEdge)");
+        for (auto& [node, currNodeEdges] : edgeData) {
+            for (auto& e: currNodeEdges) {
+                RectangleShape edgeShape = getShapeForEdge(nodes, node, get<0>(e), get<1>(e), get<2>(e));
+                window.draw(edgeShape);
+            }
         }
     }
-    drawArrowheads(edgeData, window);
+    drawArrowheads(nodes, edgeData, window);
     drawNodes(nodes, window);
+    drawStatsOverlay(window);
+    drawFrameHistogram(window);
 
+    PROFILE_SCOPE("window.display");
     window.display();
-}
\ No newline at end of file
+}
+
+void animateStep(const NodeStore& nodes, const EdgeMap& edgeData, RenderWindow& window, const chrono::milliseconds duration) {
+    {
+        PROFILE_SCOPE("animation sleep");
+        STATS_ANIMATION();
+        this_thread::sleep_for(duration);
+    }
+    refreshScreen(nodes, edgeData, window);
+}
+
+// font for the overlays, nullptr if none of the usual fonts could be loaded
+const Font* getOverlayFont() {
+    static Font font;
+    static int fontState = 0; // 0 = not tried yet, 1 = loaded, -1 = no font found
+    if (fontState == 0) {
+        fontState = -1;
+        for (const char* path: {"arial.ttf", "C:/Windows/Fonts/arial.ttf", "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", "/System/Library/Fonts/Supplemental/Arial.ttf"}) {
+            if (font.loadFromFile(path)) {
+                fontState = 1;
+                break;
+            }
+        }
+        if (fontState == -1) cout << "no font found, overlay text disabled" << endl;
+    }
+    return fontState == 1 ? &font : nullptr;
+}
+
+// counters of the last algorithm run in the top left corner
+void drawStatsOverlay(RenderWindow& window) {
+#ifdef ENABLE_RUN_STATS
+    PROFILE_SCOPE("drawStatsOverlay");
+    RunStats stats;
+    if (!lastRunStats(stats)) return;
+    const Font* font = getOverlayFont();
+    if (font == nullptr) return;
+
+    ostringstream lines;
+    lines << stats.algorithm << "\n"
+          << "settled " << stats.nodesSettled << "  relaxed " << stats.edgesRelaxed << "\n"
+          << "pushes " << stats.heapPushes << "  stale pops " << stats.stalePops << "  peak queue " << stats.peakQueueSize << "\n"
+          << "union-find ops " << stats.unionFindOps << "  bf rounds " << stats.bellmanFordRounds << "\n"
+          << "compute " << stats.computeMs << " ms  animation " << stats.animationMs << " ms";
+
+    Text text(lines.str(), *font, 11);
+    text.setFillColor(Color::Black);
+    text.setPosition(6, 4);
+    FloatRect bounds = text.getLocalBounds();
+    RectangleShape background(Vector2f(bounds.width + 12, bounds.height + 12));
+    background.setFillColor(Color(255, 255, 255, 200));
+    window.draw(background);
+    window.draw(text);
+#endif
+}
+
+// frame time histogram of the last few seconds in the bottom right corner, one bar per 4ms bucket
+void drawFrameHistogram(RenderWindow& window) {
+    PROFILE_SCOPE("drawFrameHistogram");
+    const FrameHistogram& histogram = frameHistogram();
+    const auto counts = histogram.counts();
+    const float barWidth = 6;
+    const float maxHeight = 40;
+    const Vector2f corner(window.getSize().x - FrameHistogram::numBuckets*barWidth - 8, window.getSize().y - 8);
+
+    RectangleShape background(Vector2f(FrameHistogram::numBuckets*barWidth + 4, maxHeight + 18));
+    background.setPosition(corner.x - 2, corner.y - maxHeight - 16);
+    background.setFillColor(Color(255, 255, 255, 200));
+    window.draw(background);
+
+    RectangleShape bar;
+    for (int i = 0; i < FrameHistogram::numBuckets; i++) {
+        const float height = maxHeight * counts[i] / FrameHistogram::frameWindow;
+        bar.setSize(Vector2f(barWidth - 1, height));
+        bar.setPosition(corner.x + i*barWidth, corner.y - height);
+        bar.setFillColor(i < 5 ? Color(60, 160, 60) : i < 9 ? Color(230, 160, 0) : Color(200, 40, 40)); // <20ms, <36ms, slower
+        window.draw(bar);
+    }
+
+    if (const Font* font = getOverlayFont()) {
+        ostringstream label;
+        label.precision(1);
+        label << fixed << histogram.averageMs() << " / " << histogram.worstMs() << " ms";
+        Text text(label.str(), *font, 9);
+        text.setFillColor(Color::Black);
+        text.setPosition(corner.x, corner.y - maxHeight - 15);
+        window.draw(text);
+    }
+}
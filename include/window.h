@@ -1,15 +1,28 @@
 #pragma once
 #include <vector>
-#include <memory>
+#include <chrono>
 #include "states.h"
+#include "nodestore.h"
 #include <SFML/Graphics.hpp>
 
-void drawNodes(vector<shared_ptr<Node>> nodes, RenderWindow& window);
+void drawNodes(const NodeStore& nodes, RenderWindow& window);
 
-RectangleShape getShapeForEdge(const shared_ptr<Node>& startNode, const shared_ptr<Node>& endNode, int weight, int thickness);
+// ring every node in the colour of its component, labels indexed by slot with -1 for no ring; nullptr turns it off
+void setComponentOverlay(const vector<int>* labels);
 
-void drawArrowheads(const unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, RenderWindow& window);
+Color getNodeColor(nodeState state);
+
+RectangleShape getShapeForEdge(const NodeStore& nodes, int startNode, int endNode, int weight, int thickness);
+
+void drawArrowheads(const NodeStore& nodes, const EdgeMap& edgeData, RenderWindow& window);
 
 Color getEdgeColor(int weight);
 
-void refreshScreen(const vector<shared_ptr<Node>>& nodes, const unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, RenderWindow& window);
\ No newline at end of file
+void refreshScreen(const NodeStore& nodes, const EdgeMap& edgeData, RenderWindow& window);
+
+// sleep for duration, then redraw; used between the animated steps of an algorithm
+void animateStep(const NodeStore& nodes, const EdgeMap& edgeData, RenderWindow& window, chrono::milliseconds duration);
+
+void drawStatsOverlay(RenderWindow& window);
+
+void drawFrameHistogram(RenderWindow& window);
@@ -0,0 +1,52 @@
+#include "workerpool.h"
+
+WorkerPool::WorkerPool(const int numWorkers) {
+    for (int i = 0; i < max(1, numWorkers); i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& w: workers) w.join();
+}
+
+void WorkerPool::run(const int count, const function<void(int, int)>& job) {
+    if (count <= 0) return;
+    unique_lock<mutex> guard(lock);
+    currentJob = &job;
+    jobCount = count;
+    nextIndex.store(0);
+    running = size();
+    batch++;
+    wake.notify_all();
+    finished.wait(guard, [this] { return running == 0; });
+    currentJob = nullptr;
+}
+
+void WorkerPool::workerLoop(const int workerId) {
+    int seenBatch = 0;
+    while (true) {
+        const function<void(int, int)>* job;
+        int count;
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || batch != seenBatch; });
+            if (stopping) return;
+            seenBatch = batch;
+            job = currentJob;
+            count = jobCount;
+        }
+
+        for (int i = nextIndex.fetch_add(1); i < count; i = nextIndex.fetch_add(1)) {
+            (*job)(workerId, i);
+        }
+
+        lock_guard<mutex> guard(lock);
+        if (--running == 0) finished.notify_one();
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// fixed set of threads that stay alive between batches, so per worker state (search workspaces) is reused
+class WorkerPool {
+public:
+    explicit WorkerPool(int numWorkers);
+    ~WorkerPool();
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    // run job(workerId, i) for every i in [0, count) and wait until all of them are done
+    void run(int count, const function<void(int, int)>& job);
+
+private:
+    void workerLoop(int workerId);
+
+    vector<thread> workers;
+    mutex lock;
+    condition_variable wake;
+    condition_variable finished;
+    const function<void(int, int)>* currentJob = nullptr;
+    int jobCount = 0;
+    atomic<int> nextIndex{0};
+    int batch = 0; // bumped for every run() so sleeping workers notice new work
+    int running = 0;
+    bool stopping = false;
+};
@@ -2,23 +2,29 @@
 #include <vector>
 #include <unordered_map>
 #include <utility>
-#include <memory>
 #include <cmath>
 #include <iostream>
 #include <algorithm>
 #include <random>
 #include "include/states.h"
+#include "include/nodestore.h"
 #include "include/pathfinding.h"
 #include "include/window.h"
 #include "include/mst.h"
+#include "include/generator.h"
+#include "include/profiler.h"
+#include "include/johnson.h"
+#include "include/layout.h"
+#include "include/livefeed.h"
+#include "include/components.h"
 using namespace sf;
 using namespace std;
 
 // Remove Visited, InQueue and Path Cells
-void resetPathfinding(vector<shared_ptr<Node>>& nodes, unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData) {
-    for (const auto& n: nodes) {
-        if (n->state == Visited || n->state == Path || n->state == InQueue || n->state == VisitedNoPath) {
-            n->state = Clear;
+void resetPathfinding(NodeStore& nodes, EdgeMap& edgeData) {
+    for (auto& state: nodes.states()) {
+        if (state == Visited || state == Path || state == InQueue || state == VisitedNoPath) {
+            state = Clear;
         }
     }
 
@@ -29,17 +35,18 @@ void resetPathfinding(vector<shared_ptr<Node>>& nodes, unordered_map<shared_ptr<
     }
 }
 
-void addNode(vector<shared_ptr<Node>>& nodes, const int circleRadius, RenderWindow& window) {
-    CircleShape newCircle(circleRadius-4);
+// returns the new node's slot, -1 if there was no free spot
+int addNode(NodeStore& nodes, const int circleRadius, RenderWindow& window) {
+    const float newRadius = circleRadius-4;
     Vector2f newPos;
     bool positionFound = false;
     for (float y = circleRadius+10; y < window.getSize().y-circleRadius-10; y += circleRadius * 2) {
         for (float x = circleRadius+10; x < window.getSize().x-circleRadius-10; x += circleRadius * 2) {
             newPos = Vector2f(x, y);
             bool validPosition = true;
-            for (const auto& existingNode : nodes) {
-                float combinedRadius = newCircle.getRadius() + existingNode->node.getRadius();
-                Vector2f centerDiff = newPos - existingNode->node.getPosition();
+            for (const int existingNode : nodes.slots()) {
+                float combinedRadius = newRadius + nodes.radius(existingNode);
+                Vector2f centerDiff = newPos - nodes.position(existingNode);
                 float centerDist = sqrt(centerDiff.x * centerDiff.x + centerDiff.y * centerDiff.y);
                 if (centerDist < (combinedRadius + (circleRadius*0.7))) { // Ensure new circle doesn't overlap or come too close
                     validPosition = false;
@@ -54,58 +61,40 @@ void addNode(vector<shared_ptr<Node>>& nodes, const int circleRadius, RenderWind
         if (positionFound) break;
     }
     if (positionFound) {
-        newCircle.setPosition(newPos);
-        newCircle.setOutlineColor(Color::Black);
-        newCircle.setOutlineThickness(2);
-        newCircle.setOrigin({ newCircle.getRadius(), newCircle.getRadius() });
-        nodes.push_back(make_shared<Node>(Node(newCircle)));
-    } else {
-        cout << "No possible spot found" << endl;
+        return nodes.add(newPos, newRadius);
     }
+    cout << "No possible spot found" << endl;
+    return -1;
 }
 
-void genRandomGraph(vector<shared_ptr<Node>>& nodes, unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, const int circleRadius, RenderWindow& window) {
+void genRandomGraph(NodeStore& nodes, EdgeMap& edgeData, const int circleRadius, RenderWindow& window, const GraphModel model, const uint64_t seed) {
     nodes.clear();
     edgeData.clear();
 
-    // generate nodes
-    CircleShape newCircle(circleRadius-4);
     const int ratio = 4; // used to space nodes; increase/decrease num nodes; min=2
-    const int numRows = window.getSize().x / ((circleRadius*ratio)+(circleRadius*0.7));
-    const int numCols = window.getSize().y / ((circleRadius*ratio)+(circleRadius*0.7));
-    vector<vector<shared_ptr<Node>>> nodeGrid; // keep track of added nodes in a grid to add random edges
-    for (int i=0; i<numRows; i++) {
-        nodeGrid.push_back(vector<shared_ptr<Node>>{});
-        for (int j=0; j<numCols; j++) {
-            float x=i*((circleRadius*ratio)+(circleRadius*0.7)) + (circleRadius+10);
-            float y=j*((circleRadius*ratio)+(circleRadius*0.7)) + (circleRadius+10);
-            newCircle.setPosition({x, y});
-            newCircle.setOutlineColor(Color::Black);
-            newCircle.setOutlineThickness(2);
-            newCircle.setOrigin({ newCircle.getRadius(), newCircle.getRadius() });
-            nodes.push_back(make_shared<Node>(Node(newCircle)));
-            nodeGrid[i].push_back(nodes[nodes.size()-1]);
-        }
+    GeneratorParams params;
+    params.model = model;
+    params.spacing = (circleRadius*ratio)+(circleRadius*0.7);
+    params.cols = window.getSize().x / params.spacing;
+    params.rows = window.getSize().y / params.spacing;
+    params.originX = circleRadius+10;
+    params.originY = circleRadius+10;
+    params.jitter = 0.4; // keeps jittered nodes inside the window and clear of each other
+    params.degree = (model == ErdosRenyiModel || model == BarabasiAlbertModel) ? 2 : 6;
+    params.seed = seed;
+    params.weights = {UniformWeight, 1, 5}; // getEdgeColor has a colour for weights 1-5
+    const CompactGraph graph = generateGraph(params);
+
+    nodes.reserve(graph.numNodes());
+    for (int i=0; i<graph.numNodes(); i++) {
+        nodes.add({graph.xs[i], graph.ys[i]}, circleRadius-4); // store is empty, so slot == generated index
     }
-
-    // Define possible movement directions (right, down, bottomleft, bottomright)
-    constexpr int dx[] = {1, 0, 1};
-    constexpr int dy[] = {0, 1, 1};
-    for (int row=0; row<nodeGrid.size(); row++) {
-        for (int col=0; col<nodeGrid[0].size(); col++) {
-            for (int neighborId=0; neighborId<3; neighborId++) { // make edge with right, down, and bottom right node from current
-                if (row+dx[neighborId] >= nodeGrid.size()) continue;
-                if (col+dy[neighborId] >= nodeGrid.size()) continue;
-                int direction = rand() % 2; // 0 or 1; from current node or to current node
-                int weight = rand() % 5 + 1;
-                if (direction == 0) {
-                    edgeData[nodeGrid[row][col]].emplace_back(nodeGrid[row+dx[neighborId]][col+dy[neighborId]], weight, 1);
-                } else {
-                    edgeData[nodeGrid[row+dx[neighborId]][col+dy[neighborId]]].emplace_back(nodeGrid[row][col], weight, 1);
-                }
-            }
+    for (int u=0; u<graph.numNodes(); u++) {
+        for (int e=graph.offsets[u]; e<graph.offsets[u+1]; e++) {
+            edgeData[u].emplace_back(graph.targets[e], graph.weights[e], 1);
         }
     }
+    cout << "generated " << graphModelName(model) << " graph, seed " << seed << endl;
 }
 
 // calc distance between a line and another point
@@ -117,8 +106,25 @@ float distance(Vector2f v1, Vector2f v2, Vector2f p) {
     return abs((a * p.x) + (b * p.y) + c) / sqrt((a * a) + (b * b));
 }
 
+// find the edge passing within tolerance of point; returns <from node, index in edgeData[from]> or <-1, -1>
+pair<int, int> findEdgeNear(const NodeStore& nodes, const EdgeMap& edgeData, const Vector2f point, const float tolerance) {
+    for (const auto& [node, currNodeEdges] : edgeData) {
+        for (int i = 0; i < static_cast<int>(currNodeEdges.size()); i++) {
+            Vector2f v1 = nodes.position(node);
+            Vector2f v2 = nodes.position(get<0>(currNodeEdges[i]));
+            Vector2f seg = v2 - v1;
+            float lenSq = seg.x*seg.x + seg.y*seg.y;
+            if (lenSq == 0) continue;
+            float t = ((point.x - v1.x)*seg.x + (point.y - v1.y)*seg.y) / lenSq; // projection onto the segment
+            if (t < 0 || t > 1) continue;
+            if (distance(v1, v2, point) <= tolerance) return {node, i};
+        }
+    }
+    return {-1, -1};
+}
+
 // check if edge between start and end node exists
-bool doesConnectionExist(unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual>& edgeData, shared_ptr<Node>& start, shared_ptr<Node>& end) {
+bool doesConnectionExist(EdgeMap& edgeData, const int start, const int end) {
     for (const auto& edge : edgeData[start]) {
         if (get<0>(edge) == end) return true;
     }
@@ -131,66 +137,145 @@ int main() {
     // Define two circles
     int nodeRadius = 10;
     if (nodeRadius < 5) nodeRadius = 5; // anything smaller wont render
-    vector<shared_ptr<Node>> nodes;
+    NodeStore nodes;
 
-    // key=node, val=<end_node, weight, thickness>
-    unordered_map<shared_ptr<Node>, vector<tuple<shared_ptr<Node>, int, int>>, NodePtrHash, NodePtrEqual> edgeData;
+    // key=node slot, val=<end_node, weight, thickness>
+    EdgeMap edgeData;
 
     // set 2 default nodes with 1 edge
-    CircleShape node1(nodeRadius-4);
-    node1.setPosition(100, 100);
-    node1.setOutlineColor(Color::Black);
-    node1.setOutlineThickness(2);
-    node1.setOrigin({ node1.getRadius(), node1.getRadius() });
-    nodes.push_back(make_shared<Node>(Node(node1)));
-
-    CircleShape node2(nodeRadius-4);
-    node2.setPosition(300, 300);
-    node2.setOutlineColor(Color::Black);
-    node2.setOutlineThickness(2);
-    node2.setOrigin({ node2.getRadius(), node2.getRadius() });
-    nodes.push_back(make_shared<Node>(Node(node2)));
-
-    edgeData[nodes[0]].emplace_back(nodes[1], 1, 1); // edge from node1 to node2
+    int node1 = nodes.add({100, 100}, nodeRadius-4);
+    int node2 = nodes.add({300, 300}, nodeRadius-4);
+
+    edgeData[node1].emplace_back(node2, 1, 1); // edge from node1 to node2
+
+    // bumped by every edit of nodes or edges; the path cache, component index and layout rebuild when it changes
+    long long graphVersion = 0;
+    JohnsonPotentials potentials;
+    ComponentIndex components; // scc labels per graph version; rejects unreachable queries and drives the C overlay
+    bool showComponents = false;
+    PathCache pathCache(64u << 20); // bytes of paused searches kept, so moving only the end node reuses the last search
+    ForceLayout layout;
 
     int currCircle = -1;
     int lineStartIdx=-1;
     bool isShiftPressed = false;
     bool isCtrlPressed = false;
-    shared_ptr<Node> startNode;
-    shared_ptr<Node> endNode;
+    int startNode = -1;
+    int endNode = -1;
+    GraphModel graphModel = GridModel;
+    uint64_t graphSeed = random_device{}();
+    Clock frameClock;
+
+    LiveFeed liveFeed;
+    vector<EdgeUpdate> feedBatch;
+    Keyboard::Key activeQuery = Keyboard::Unknown; // algorithm key last run, rerun when the live feed changes the graph
+
+    // run the algorithm bound to key 1-5; live reruns skip the animation and console output
+    auto runQuery = [&](const Keyboard::Key key, const bool animate) {
+        if (startNode == -1 || endNode == -1) return;
+        resetPathfinding(nodes, edgeData);
+        // dijkstra would explore all of start's reachable region before giving up; bellman-ford is not rejected early
+        // since it reports a negative cycle reachable from start even when end is unreachable
+        auto unreachable = [&] {
+            components.update(nodes, edgeData, graphVersion);
+            if (components.reachable(startNode, endNode)) return false;
+            if (animate) cout << "no path found, end is not reachable from start" << endl;
+            return true;
+        };
+        if (key == Keyboard::Num1) {
+            if (unreachable()) return;
+            for (const auto& [node, currNodeEdges] : edgeData) {
+                if (animate && any_of(currNodeEdges.begin(), currNodeEdges.end(), [](const auto& e) { return get<1>(e) < 0; })) {
+                    cout << "graph has negative weights, dijkstra may be wrong; use bellman-ford (2) or johnson (5)" << endl;
+                    break;
+                }
+            }
+            findDijkstraPath(nodes, edgeData, window, startNode, endNode, graphVersion, pathCache, nullptr, animate);
+        } else if (key == Keyboard::Num2) {
+            bellmanFord(nodes, edgeData, window, startNode, endNode, animate);
+        } else if (key == Keyboard::Num3) {
+            kruskal(nodes, edgeData, window, animate);
+        } else if (key == Keyboard::Num4) {
+            prim(nodes, edgeData, window, animate);
+        } else if (key == Keyboard::Num5) {
+            if (!potentials.update(nodes, edgeData)) {
+                if (animate) cout << "Graph contains a negative-weight cycle" << endl;
+                return;
+            }
+            if (unreachable()) return;
+            findDijkstraPath(nodes, edgeData, window, startNode, endNode, graphVersion, pathCache, &potentials, animate);
+        }
+    };
 
     while (window.isOpen()) {
+        PROFILE_SCOPE("frame");
+        frameHistogram().record(frameClock.restart().asSeconds() * 1000);
         Event event{};
         while (window.pollEvent(event)) {
+            PROFILE_SCOPE("handle event");
             if (event.type == Event::Closed)
                 window.close();
 
             // begin search
-            else if (event.type == Event::KeyReleased && event.key.code == Keyboard::Num1) {
-                if (startNode == nullptr) continue;
-                if (endNode == nullptr) continue;
-                resetPathfinding(nodes, edgeData);
-                findDijkstraPath(nodes, edgeData, window, startNode, endNode);
+            else if (event.type == Event::KeyReleased && event.key.code >= Keyboard::Num1 && event.key.code <= Keyboard::Num5) {
+                activeQuery = event.key.code;
+                runQuery(activeQuery, true);
             }
-            else if (event.type == Event::KeyReleased && event.key.code == Keyboard::Num2) {
-                if (startNode == nullptr) continue;
-                if (endNode == nullptr) continue;
-                resetPathfinding(nodes, edgeData);
-                bellmanFord(nodes, edgeData, window, startNode, endNode);
-                //kruskal(nodes, edgeData, window);
+
+            // start/stop reading edge updates from the live feed pipe
+            else if (event.type == Event::KeyReleased && event.key.code == Keyboard::F) {
+                if (liveFeed.running()) {
+                    liveFeed.stop();
+                    cout << "live feed stopped" << endl;
+                } else if (liveFeed.start("edge_feed")) {
+                    cout << "reading edge updates from edge_feed" << endl;
+                }
             }
-            else if (event.type == Event::KeyReleased && event.key.code == Keyboard::Num3) {
-                if (startNode == nullptr) continue;
-                if (endNode == nullptr) continue;
-                resetPathfinding(nodes, edgeData);
-                kruskal(nodes,edgeData, window);
+
+            // save the graph for the headless query runner
+            else if (event.type == Event::KeyReleased && event.key.code == Keyboard::S) {
+                vector<int> indexToSlot;
+                if (saveGraph("graph.txt", snapshotGraph(nodes, edgeData, indexToSlot))) {
+                    cout << "saved graph to graph.txt" << endl;
+                } else {
+                    cout << "could not write graph.txt" << endl;
+                }
             }
-            else if (event.type == Event::KeyReleased && event.key.code == Keyboard::Num4) {
-                if (startNode == nullptr) continue;
-                if (endNode == nullptr) continue;
-                resetPathfinding(nodes, edgeData);
-                prim(nodes, edgeData, window);
+
+            // toggle the force directed layout, it runs one iteration per frame until it settles
+            else if (event.type == Event::KeyReleased && event.key.code == Keyboard::L) {
+                if (layout.running()) {
+                    layout.stop();
+                } else {
+                    LayoutParams params;
+                    params.gap = nodeRadius*0.7; // same spacing the drag collision check keeps
+                    params.bounded = true; // same area a node can be dragged in
+                    params.minX = nodeRadius;
+                    params.minY = nodeRadius;
+                    params.maxX = window.getSize().x-nodeRadius;
+                    params.maxY = window.getSize().y-nodeRadius;
+                    layout.start(nodes, edgeData, graphVersion, params);
+                }
+            }
+
+            // ring the nodes of every strongly connected component (2+ nodes) in its own colour
+            else if (event.type == Event::KeyReleased && event.key.code == Keyboard::C) {
+                showComponents = !showComponents;
+                if (showComponents) {
+                    components.update(nodes, edgeData, graphVersion);
+                    cout << components.numComponents() << " strongly connected components" << endl;
+                }
+                setComponentOverlay(showComponents ? &components.labels() : nullptr);
+            }
+
+            // write the profiler ring buffers as a chrome trace
+            else if (event.type == Event::KeyReleased && event.key.code == Keyboard::F9) {
+                int numEvents = dumpChromeTrace("profile_trace.json");
+                if (numEvents < 0) {
+                    cout << "could not write profile_trace.json (profiler disabled?)" << endl;
+                } else {
+                    cout << "wrote " << numEvents << " events to profile_trace.json" << endl;
+                }
             }
 
             // add start/end node
@@ -202,38 +287,36 @@ int main() {
             }
             else if (isShiftPressed && Mouse::isButtonPressed(Mouse::Left)) { // set start node
                 Vector2f mousePos = Vector2f(Mouse::getPosition(window));
-                for (int i = 0; i < nodes.size(); i++) {
-                    if (nodes[i]->node.getGlobalBounds().contains(mousePos)) {
-                        for (auto& n: nodes) {
-                            if (n->state == Start) {
-                                n->state = Clear;
-                            }
+                int clicked = nodes.findAt(mousePos);
+                if (clicked != -1) {
+                    for (auto& state: nodes.states()) {
+                        if (state == Start) {
+                            state = Clear;
                         }
-                        startNode = nodes[i];
-                        nodes[i]->state = Start;
-                        if (startNode == endNode) { // override endnode
-                            endNode = nullptr;
-                        }
-                        resetPathfinding(nodes, edgeData);
                     }
+                    startNode = clicked;
+                    nodes.state(clicked) = Start;
+                    if (startNode == endNode) { // override endnode
+                        endNode = -1;
+                    }
+                    resetPathfinding(nodes, edgeData);
                 }
             }
             else if (isShiftPressed && Mouse::isButtonPressed(Mouse::Right)) { // set end node
                 Vector2f mousePos = Vector2f(Mouse::getPosition(window));
-                for (int i = 0; i < nodes.size(); i++) {
-                    if (nodes[i]->node.getGlobalBounds().contains(mousePos)) {
-                        for (auto& n: nodes) {
-                            if (n->state == End) {
-                                n->state = Clear;
-                            }
-                        }
-                        endNode = nodes[i];
-                        nodes[i]->state = End;
-                        if (endNode == startNode) { // override startnode
-                            startNode = nullptr;
+                int clicked = nodes.findAt(mousePos);
+                if (clicked != -1) {
+                    for (auto& state: nodes.states()) {
+                        if (state == End) {
+                            state = Clear;
                         }
-                        resetPathfinding(nodes, edgeData);
                     }
+                    endNode = clicked;
+                    nodes.state(clicked) = End;
+                    if (endNode == startNode) { // override startnode
+                        startNode = -1;
+                    }
+                    resetPathfinding(nodes, edgeData);
                 }
             }
 
@@ -249,38 +332,33 @@ int main() {
                 if (!(mousePos.x >= 0 && mousePos.x <= window.getSize().x && mousePos.y >= 0 && mousePos.y <= window.getSize().y)) continue;
 
                 // delete node
-                for (int i = 0; i < nodes.size(); i++) {
-                    if (nodes[i]->node.getGlobalBounds().contains(mousePos)) {
-                        shared_ptr<Node> removedNode = nodes[i];
-                        if (removedNode->state == Start) {
-                            startNode = nullptr;
-                        } else if (removedNode->state == End) {
-                            endNode = nullptr;
-                        }
+                int removedNode = nodes.findAt(mousePos);
+                if (removedNode != -1) {
+                    // compare slots, not states: an mst run paints start and end as Path
+                    if (removedNode == startNode) {
+                        startNode = -1;
+                    } else if (removedNode == endNode) {
+                        endNode = -1;
+                    }
 
-                        // delete edges going to this node
-                        for (auto& [node, currNodeEdges] : edgeData) {
-                            int j = 0;
-                            for (auto& e: currNodeEdges) {
-                                if (get<0>(e) == removedNode) {
-                                    edgeData[node].erase(edgeData[node].begin()+j);
-                                }
-                                j++;
-                            }
-                        }
-                        edgeData.erase(nodes[i]); // delete edges coming from this node
-                        nodes.erase(nodes.begin() + i);
-                        resetPathfinding(nodes, edgeData);
-                        break;  // Exit loop after deleting the node and its edges
+                    // delete edges going to this node
+                    for (auto& [node, currNodeEdges] : edgeData) {
+                        erase_if(currNodeEdges, [removedNode](const auto& e) { return get<0>(e) == removedNode; });
                     }
+                    edgeData.erase(removedNode); // delete edges coming from this node
+                    nodes.remove(removedNode); // the slot may be reused, so no edge may still point at it
+                    graphVersion++;
+                    potentials.edgesRemoved();
+                    resetPathfinding(nodes, edgeData);
                 }
 
                 // delete edge
+                PROFILE_SCOPE("hit-test edges");
                 for (auto& [node, currNodeEdges] : edgeData) {
                     for (auto it = currNodeEdges.begin(); it != currNodeEdges.end(); ) {
                         auto& e = *it;
 
-                        RectangleShape edgeShape = getShapeForEdge(node, get<0>(e), get<1>(e), get<2>(e));
+                        RectangleShape edgeShape = getShapeForEdge(nodes, node, get<0>(e), get<1>(e), get<2>(e));
                         std::array<Vector2f, 4> vertices;
                         for (int vertexId = 0; vertexId < 4; ++vertexId) {
                             vertices[vertexId] = edgeShape.getTransform().transformPoint(edgeShape.getPoint(vertexId));
@@ -296,6 +374,8 @@ int main() {
                         }
                         if (cursorInEdge) {
                             it = currNodeEdges.erase(it); // Erase returns the next iterator
+                            graphVersion++;
+                            potentials.edgesRemoved();
                             resetPathfinding(nodes, edgeData);
                         } else {
                             ++it; // Increment iterator if not erasing
@@ -304,29 +384,40 @@ int main() {
                 }
             }
 
+            // change edge weight with the mouse wheel, skipping 0; range -5..5
+            else if (event.type == Event::MouseWheelScrolled) {
+                Vector2f mousePos(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+                auto [from, edgeIdx] = findEdgeNear(nodes, edgeData, mousePos, 5);
+                if (from == -1) continue;
+                auto& e = edgeData[from][edgeIdx];
+                int weight = get<1>(e) + (event.mouseWheelScroll.delta > 0 ? 1 : -1);
+                if (weight == 0) weight += (event.mouseWheelScroll.delta > 0 ? 1 : -1);
+                weight = clamp(weight, -5, 5);
+                if (weight == get<1>(e)) continue;
+                get<1>(e) = weight;
+                graphVersion++;
+                potentials.edgeChanged(from, get<0>(e), weight);
+                resetPathfinding(nodes, edgeData);
+                cout << "edge weight: " << weight << endl;
+            }
+
             // add edge
             else if (event.type == Event::MouseButtonPressed && event.mouseButton.button == Mouse::Right) {
                 Vector2f mousePos = Vector2f(Mouse::getPosition(window));
-                for (int i = 0; i < nodes.size(); i++) {
-                    if (nodes[i]->node.getGlobalBounds().contains(mousePos)) {
-                        lineStartIdx = i;
-                        break;
-                    }
-                }
+                lineStartIdx = nodes.findAt(mousePos);
             }
             else if (lineStartIdx!=-1 && event.type == Event::MouseButtonReleased && event.mouseButton.button == Mouse::Right) {
                 Vector2f mousePos = Vector2f(Mouse::getPosition(window));
-                for (int lineEndIdx = 0; lineEndIdx < nodes.size(); lineEndIdx++) {
-                    if (lineStartIdx == lineEndIdx) continue; // cant make a self edge
-                    if (nodes[lineEndIdx]->node.getGlobalBounds().contains(mousePos)) {
-                        if (!doesConnectionExist(edgeData, nodes[lineStartIdx], nodes[lineEndIdx])) {
-                            edgeData[nodes[lineStartIdx]].emplace_back(nodes[lineEndIdx], 1, 1);
-                            resetPathfinding(nodes, edgeData);
-                        }
-
-                        lineStartIdx = -1;
-                        break;
+                int lineEndIdx = nodes.findAt(mousePos);
+                if (lineEndIdx != -1 && lineEndIdx != lineStartIdx) { // cant make a self edge
+                    if (!doesConnectionExist(edgeData, lineStartIdx, lineEndIdx)) {
+                        edgeData[lineStartIdx].emplace_back(lineEndIdx, 1, 1);
+                        graphVersion++;
+                        potentials.edgeChanged(lineStartIdx, lineEndIdx, 1);
+                        resetPathfinding(nodes, edgeData);
                     }
+
+                    lineStartIdx = -1;
                 }
             }
 
@@ -334,35 +425,44 @@ int main() {
             else if (event.type == Event::MouseButtonPressed && event.mouseButton.button == Mouse::Left) {
                 Vector2f mousePos = Vector2f(Mouse::getPosition(window));
                 if (mousePos.x < (nodeRadius) || mousePos.x > window.getSize().x-nodeRadius || mousePos.y < nodeRadius || mousePos.y > window.getSize().y-nodeRadius) continue;
-                for (int i = 0; i < nodes.size(); i++) {
-                    if (nodes[i]->node.getGlobalBounds().contains(mousePos)) {
-                        currCircle = i;
-                    }
+                int clicked = nodes.findAt(mousePos);
+                if (clicked != -1) {
+                    currCircle = clicked;
                 }
             }
             else if (currCircle != -1 && event.type == Event::MouseButtonReleased) {
                 currCircle = -1;
             }
 
-            // generate random graph
+            // generate random graph; G switches to the next generator model
             else if (event.type == Event::KeyReleased) {
-                if (event.key.code == Keyboard::Space) {
-                    startNode = nullptr;
-                    endNode = nullptr;
-                    genRandomGraph(nodes, edgeData, nodeRadius, window);
+                if (event.key.code == Keyboard::Space || event.key.code == Keyboard::G) {
+                    if (event.key.code == Keyboard::G) {
+                        graphModel = static_cast<GraphModel>((graphModel + 1) % (DelaunayModel + 1));
+                    }
+                    startNode = -1;
+                    endNode = -1;
+                    genRandomGraph(nodes, edgeData, nodeRadius, window, graphModel, graphSeed++);
+                    graphVersion++;
+                    potentials.invalidate();
                 }
             }
 
             // add new node
             else if (event.type == Event::KeyPressed) {
                 if (event.key.code == Keyboard::A) {
-                    addNode(nodes, nodeRadius, window);
+                    int added = addNode(nodes, nodeRadius, window);
+                    if (added != -1) {
+                        graphVersion++;
+                        potentials.nodeAdded(added);
+                    }
                 }
             }
         }
 
         // Dragging logic
         if (currCircle != -1 && Mouse::isButtonPressed(Mouse::Left)) {
+            PROFILE_SCOPE("drag");
             Vector2f mousePos = Vector2f(Mouse::getPosition(window));
             if (mousePos.x < (nodeRadius) || mousePos.x > window.getSize().x-nodeRadius || mousePos.y < nodeRadius || mousePos.y > window.getSize().y-nodeRadius) continue;
 
@@ -370,22 +470,33 @@ int main() {
 
             // Check collision before updating position
             bool collisionDetected = false;
-            for (int i = 0; i < nodes.size(); i++) {
+            for (const int i : nodes.slots()) {
                 if (i == currCircle) continue;
                 Vector2f currCirclePoints = newPos;
-                Vector2f otherCirclePoints = nodes[i]->node.getPosition();
+                Vector2f otherCirclePoints = nodes.position(i);
                 float distance = sqrt(pow(currCirclePoints.x - otherCirclePoints.x, 2) + pow(currCirclePoints.y - otherCirclePoints.y, 2));
-                if (distance < nodes[currCircle]->node.getRadius() + nodes[i]->node.getRadius() + (nodeRadius*0.7)) {
+                if (distance < nodes.radius(currCircle) + nodes.radius(i) + (nodeRadius*0.7)) {
                     collisionDetected = true;
                     break;
                 }
             }
 
             if (!collisionDetected) {
-                nodes[currCircle]->node.setPosition(newPos); // Update position if no collision detected
+                nodes.setPosition(currCircle, newPos); // Update position if no collision detected
+            }
+        }
+
+        // live feed updates are applied once per frame, so a burst of them costs one version bump and one rerun
+        if (liveFeed.drain(feedBatch) > 0) {
+            if (applyEdgeUpdates(nodes, edgeData, feedBatch, potentials) > 0) {
+                graphVersion++;
+                runQuery(activeQuery, false);
             }
+            feedBatch.clear();
         }
 
+        layout.step(nodes, edgeData, graphVersion, currCircle); // the held node stays under the mouse
+        if (showComponents) components.update(nodes, edgeData, graphVersion); // edits this frame recolour the overlay
         refreshScreen(nodes, edgeData, window);
     }
 
@@ -0,0 +1,238 @@
+// headless batch query runner: loads a graph, reads queries from stdin and prints one result line per query
+//
+// usage: graph_query [options] <graph-file> [threads]
+//        graph_query [options] --gen <grid|erdos-renyi|geometric|barabasi-albert|delaunay> <rows> <cols> <seed> [threads]
+// options:
+//   --weights <i32|u8|f32>   edge weight storage, u8 quarters the weight array of memory bound runs (default i32)
+//   --undirected             store every edge in both directions
+//   --cache <megabytes>      keep paused dijkstra searches per source, so repeated sources resume instead of restarting (default 0, off)
+//
+// queries:
+//   sp <src> <dst> <dijkstra|bellman-ford|johnson>  ->  <distance> <path nodes...> | no path | negative cycle
+//   mst <kruskal|prim>                              ->  <weight> <num edges>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <charconv>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include "include/graph.h"
+#include "include/engine.h"
+#include "include/pathcache.h"
+#include "include/reachability.h"
+#include "include/generator.h"
+#include "include/parallel.h"
+#include "include/workerpool.h"
+using namespace std;
+
+// whole string must be a number; false instead of the exception stoi/stoull would throw
+template <typename T>
+bool parseNumber(const string& text, T& value) {
+    const auto [end, error] = from_chars(text.data(), text.data() + text.size(), value);
+    return error == errc() && end == text.data() + text.size();
+}
+
+bool parseModel(const string& name, GraphModel& model) {
+    const pair<const char*, GraphModel> models[] = {
+        {"grid", GridModel}, {"erdos-renyi", ErdosRenyiModel}, {"geometric", GeometricModel},
+        {"barabasi-albert", BarabasiAlbertModel}, {"delaunay", DelaunayModel},
+    };
+    for (const auto& [modelName, value]: models) {
+        if (name == modelName) {
+            model = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// johnson's potentials, computed by the first johnson query and shared by every later one
+template <typename Dist>
+struct SharedPotentials {
+    once_flag computed;
+    bool valid = false;
+    vector<Dist> values;
+};
+
+// component index, built by the first shortest path query so unreachable pairs are answered without a search
+struct SharedReachability {
+    once_flag built;
+    ReachabilityIndex index;
+};
+
+template <typename Graph, typename Dist>
+string answerQuery(const Graph& graph, const string& line, SharedPotentials<Dist>& potentials, BasicPathCache<Dist>& cache,
+                   SharedReachability& reachability) {
+    istringstream fields(line);
+    string kind, algorithm;
+    fields >> kind;
+    ostringstream out;
+
+    if (kind == "sp") {
+        int src, dst;
+        if (!(fields >> src >> dst >> algorithm)) return "error: expected sp <src> <dst> <algo>";
+        if (src < 0 || src >= graph.numNodes() || dst < 0 || dst >= graph.numNodes()) return "error: node out of range";
+        if (algorithm != "dijkstra" && algorithm != "bellman-ford" && algorithm != "johnson") {
+            return "error: unknown shortest path algorithm '" + algorithm + "'";
+        }
+        if (algorithm == "johnson") {
+            call_once(potentials.computed, [&] { potentials.valid = computePotentials(graph, potentials.values); });
+            if (!potentials.valid) return "negative cycle";
+        }
+        // unreachable pairs need no search; bellman-ford still runs to report a negative cycle reachable from src
+        if (algorithm != "bellman-ford") {
+            call_once(reachability.built, [&] { reachability.index.build(graph); });
+            if (!reachability.index.reachable(src, dst)) return "no path";
+        }
+        BasicPathResult<Dist> result;
+        if (algorithm == "dijkstra") {
+            result = cache.query(graph, 0, src, dst); // the loaded graph never changes, so it stays at version 0
+        } else if (algorithm == "bellman-ford") {
+            result = bellmanFordQuery(graph, src, dst, threadWorkspace<Dist>());
+        } else {
+            result = cache.query(graph, 0, src, dst, NullObserver{}, &potentials.values);
+        }
+        if (result.negativeCycle) return "negative cycle";
+        if (!result.reachable) return "no path";
+        out << result.distance;
+        for (const int n: result.path) out << " " << n;
+        return out.str();
+    }
+
+    if (kind == "mst") {
+        if (!(fields >> algorithm)) return "error: expected mst <algo>";
+        BasicMstResult<Dist> result;
+        if (algorithm == "kruskal") {
+            result = kruskalMst(graph);
+        } else if (algorithm == "prim") {
+            result = primMst(graph);
+        } else {
+            return "error: unknown mst algorithm '" + algorithm + "'";
+        }
+        out << result.weight << " " << result.numEdges;
+        return out.str();
+    }
+
+    return "error: unknown query '" + kind + "'";
+}
+
+// answer stdin queries in batches so output stays in input order while the pool works on many at once
+template <typename Graph>
+void runQueries(const Graph& graph, const int numThreads, const size_t cacheBytes) {
+    using Dist = DistanceOf<typename Graph::WeightType>;
+    WorkerPool pool(numThreads);
+    SharedPotentials<Dist> potentials;
+    SharedReachability reachability;
+    BasicPathCache<Dist> cache(cacheBytes);
+    const size_t batchSize = 4096;
+    vector<string> lines;
+    vector<string> results;
+    string line;
+    bool moreInput = true;
+    while (moreInput) {
+        lines.clear();
+        while (lines.size() < batchSize && (moreInput = static_cast<bool>(getline(cin, line)))) {
+            if (line.empty() || line[0] == '#') continue;
+            lines.push_back(line);
+        }
+        results.assign(lines.size(), "");
+        pool.run(static_cast<int>(lines.size()), [&](int, const int i) { // engines use the worker thread's threadWorkspace
+            results[i] = answerQuery(graph, lines[i], potentials, cache, reachability);
+        });
+        for (const auto& result: results) cout << result << '\n';
+        cout.flush();
+    }
+}
+
+template <typename Weight, typename Direction>
+int runWithPolicies(CompactGraph&& source, const int numThreads, const size_t cacheBytes) {
+    BasicGraph<Weight, Direction> graph;
+    if constexpr (is_same_v<BasicGraph<Weight, Direction>, CompactGraph>) {
+        graph = move(source);
+    } else {
+        if (!convertGraph(source, graph)) {
+            cerr << "edge weights do not fit the requested weight type" << endl;
+            return 1;
+        }
+        source = CompactGraph{};
+    }
+    runQueries(graph, numThreads, cacheBytes);
+    return 0;
+}
+
+template <typename Direction>
+int runWithDirection(CompactGraph&& source, const string& weightType, const int numThreads, const size_t cacheBytes) {
+    if (weightType == "u8") return runWithPolicies<uint8_t, Direction>(move(source), numThreads, cacheBytes);
+    if (weightType == "f32") return runWithPolicies<float, Direction>(move(source), numThreads, cacheBytes);
+    return runWithPolicies<int32_t, Direction>(move(source), numThreads, cacheBytes);
+}
+
+int usage() {
+    cerr << "usage: graph_query [--weights i32|u8|f32] [--undirected] [--cache MB] <graph-file> [threads]" << endl
+         << "       graph_query [--weights i32|u8|f32] [--undirected] [--cache MB] --gen <model> <rows> <cols> <seed> [threads]" << endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+    vector<string> args;
+    string weightType = "i32";
+    bool undirected = false;
+    size_t cacheBytes = 0;
+    for (int i = 1; i < argc; i++) {
+        const string arg = argv[i];
+        if (arg == "--undirected") {
+            undirected = true;
+        } else if (arg == "--weights" && i + 1 < argc) {
+            weightType = argv[++i];
+        } else if (arg == "--cache" && i + 1 < argc) {
+            if (!parseNumber(argv[++i], cacheBytes)) return usage();
+            cacheBytes <<= 20;
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (weightType != "i32" && weightType != "u8" && weightType != "f32") {
+        cerr << "unknown weight type " << weightType << endl;
+        return 1;
+    }
+    CompactGraph graph;
+    int numThreads = defaultThreadCount();
+
+    auto loadStart = chrono::steady_clock::now();
+    if (args.size() >= 5 && args[0] == "--gen") {
+        GeneratorParams params;
+        if (!parseModel(args[1], params.model)) {
+            cerr << "unknown model " << args[1] << endl;
+            return 1;
+        }
+        if (!parseNumber(args[2], params.rows) || !parseNumber(args[3], params.cols) || !parseNumber(args[4], params.seed)
+            || (args.size() >= 6 && !parseNumber(args[5], numThreads))) {
+            return usage();
+        }
+        if (static_cast<long long>(params.rows) * params.cols > numeric_limits<int>::max()) { // node ids are int
+            cerr << "rows * cols must be at most " << numeric_limits<int>::max() << endl;
+            return 1;
+        }
+        params.degree = params.model == BarabasiAlbertModel ? 3 : 6;
+        params.numThreads = numThreads;
+        graph = generateGraph(params);
+    } else if (args.size() == 1 || args.size() == 2) {
+        if (args.size() == 2 && !parseNumber(args[1], numThreads)) return usage();
+        string error;
+        if (!loadGraph(args[0], graph, error)) {
+            cerr << error << endl;
+            return 1;
+        }
+    } else {
+        return usage();
+    }
+    chrono::duration<double> loadTime = chrono::steady_clock::now() - loadStart;
+    cerr << "graph: " << graph.numNodes() << " nodes, " << graph.numEdges() << " edges, ready in " << loadTime.count() << "s" << endl;
+
+    if (undirected) return runWithDirection<Undirected>(move(graph), weightType, numThreads, cacheBytes);
+    return runWithDirection<Directed>(move(graph), weightType, numThreads, cacheBytes);
+}
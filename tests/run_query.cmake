@@ -0,0 +1,14 @@
+# runs graph_query on <NAME>.txt with <NAME>.queries on stdin and compares stdout with <NAME>.expected
+# usage: cmake -DQUERY=<graph_query> -DDIR=<tests dir> -DNAME=<case> -P run_query.cmake
+execute_process(COMMAND ${QUERY} ${DIR}/${NAME}.txt
+                INPUT_FILE ${DIR}/${NAME}.queries
+                OUTPUT_VARIABLE output
+                RESULT_VARIABLE result
+                TIMEOUT 10)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "graph_query exited with ${result}")
+endif()
+file(READ ${DIR}/${NAME}.expected expected)
+if (NOT output STREQUAL expected)
+    message(FATAL_ERROR "unexpected output:\n${output}\nexpected:\n${expected}")
+endif()